@@ -0,0 +1,142 @@
+#pragma once
+
+#include "core/Bin.h"
+#include "primitives/MArea.h"
+#include "primitives/MPointDouble.h"
+#include "primitives/Rectangle.h"
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace BenchUtils {
+
+inline MArea createRect(double x, double y, double w, double h, int id) {
+    std::vector<MPointDouble> points = {
+        {x, y}, {x + w, y}, {x + w, y + h}, {x, y + h}
+    };
+    return MArea(points, id);
+}
+
+/**
+ * @brief Creates a convex polygon approximating an ellipse with the given number of vertices.
+ */
+inline MArea createPolygon(double x, double y, double w, double h, int nVertices, int id) {
+    const double pi = 3.14159265358979323846;
+    std::vector<MPointDouble> points;
+    points.reserve(nVertices);
+    for (int i = 0; i < nVertices; ++i) {
+        double angle = 2.0 * pi * i / nVertices;
+        points.emplace_back(x + w / 2.0 * (1.0 + std::cos(angle)), y + h / 2.0 * (1.0 + std::sin(angle)));
+    }
+    return MArea(points, id);
+}
+
+/**
+ * @brief Seeded set of random convex polygons with the given vertex count, reproducible between runs.
+ */
+inline std::vector<MArea> syntheticPolygons(size_t count, double minSide, double maxSide, int nVertices, unsigned seed = 42) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> side(minSide, maxSide);
+    std::vector<MArea> pieces;
+    pieces.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        pieces.push_back(createPolygon(0, 0, std::round(side(rng)), std::round(side(rng)), nVertices, static_cast<int>(i + 1)));
+    }
+    return pieces;
+}
+
+/**
+ * @brief Builds a bin filled by the bounding-box stage followed by a drop pass,
+ * the same sequence used by BinPacking::pack for a single bin.
+ */
+inline Bin filledBin(const Rectangle2D& dimension, std::vector<MArea> pieces) {
+    Bin bin(dimension);
+    std::vector<MArea> notPlaced = bin.boundingBoxPacking(pieces, false);
+    bin.dropPieces(notPlaced, false);
+    return bin;
+}
+
+} // namespace BenchUtils
+
+/**
+ * @brief Grants the benchmarks access to the private hot-path helpers of Bin.
+ * Declared as a friend in Bin.h, mirroring the BinTest fixture.
+ */
+class BinBenchmarkAccess {
+public:
+    static bool isCollision(Bin& bin, const MArea& piece) {
+        return bin.isCollision(piece);
+    }
+
+    static void computeFreeRectangles(Bin& bin, const Rectangle2D& justPlacedPieceBB) {
+        bin.computeFreeRectangles(justPlacedPieceBB);
+    }
+
+    static void eliminateNonMaximal(Bin& bin) {
+        bin.eliminateNonMaximal();
+    }
+
+    static auto& freeRectangles(Bin& bin) {
+        return bin.freeRectangles;
+    }
+
+    /**
+     * @brief Moves the index entry of every placed piece by a unit step down and back, rounds
+     * times, as the steps of compress passes do. The pieces themselves stay where they are.
+     */
+    static void churnSpatialIndex(Bin& bin, size_t rounds) {
+        for (size_t r = 0; r < rounds; ++r) {
+            for (size_t i = 0; i < bin.placedPieces.size(); ++i) {
+                Rectangle2D box = bin.placedPieces[i].getBoundingBox2D();
+                bin.spatialIndex.update(i, shifted(box, 0, -1));
+                bin.spatialIndex.update(i, box);
+            }
+        }
+    }
+
+    /**
+     * @brief Replaces the index entry of a placed piece, as compressPiece does after a slide.
+     */
+    static void updateSpatialIndex(Bin& bin, size_t index, const Rectangle2D& box) {
+        bin.spatialIndex.update(index, box);
+    }
+
+    /**
+     * @brief The broad phase alone: the number of placed pieces whose box meets the given one.
+     */
+    static size_t querySpatialIndex(Bin& bin, const Rectangle2D& box) {
+        size_t found = 0;
+        bin.spatialIndex.query(box, [&found](size_t, const Rectangle2D&) { found++; });
+        return found;
+    }
+
+    static Rectangle2D shifted(const Rectangle2D& box, double dx, double dy) {
+        return Rectangle2D(MPointDouble(box.min_corner().x() + dx, box.min_corner().y() + dy),
+                           MPointDouble(box.max_corner().x() + dx, box.max_corner().y() + dy));
+    }
+
+    /**
+     * @brief Runs only the maximal-rectangles bookkeeping for a sequence of seeded random
+     * boxes, producing a realistic free-rectangle list without placing real pieces.
+     */
+    static void splitRandomBoxes(Bin& bin, size_t count, double minSide, double maxSide, unsigned seed = 42) {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<double> side(minSide, maxSide);
+        for (size_t i = 0; i < count; ++i) {
+            double w = std::round(side(rng));
+            double h = std::round(side(rng));
+            MArea box = BenchUtils::createRect(0, 0, w, h, -1);
+            Bin::Placement placement = bin.findWhereToPlace(box, false);
+            if (placement.rectIndex == -1) {
+                continue;
+            }
+            if (placement.requiresRotation) {
+                std::swap(w, h);
+            }
+            const Rectangle2D& freeRect = bin.freeRectangles[placement.rectIndex];
+            MPointDouble corner = freeRect.min_corner();
+            bin.computeFreeRectangles(Rectangle2D(corner, MPointDouble(corner.x() + w, corner.y() + h)));
+            bin.eliminateNonMaximal();
+        }
+    }
+};
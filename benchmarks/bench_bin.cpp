@@ -0,0 +1,125 @@
+#include <benchmark/benchmark.h>
+#include "BenchUtils.h"
+#include "core/Bin.h"
+#include <random>
+
+// Microbenchmarks for the Bin hot paths. The argument is the number of pieces (or boxes) offered to the bin.
+
+namespace {
+    const Rectangle2D kBinDimension(MPointDouble(0, 0), MPointDouble(2000, 1200));
+
+    Bin polygonBin(size_t nPieces) {
+        return BenchUtils::filledBin(kBinDimension, BenchUtils::syntheticPolygons(nPieces, 40, 160, 24));
+    }
+
+    // Probes spread over the whole bin so that both hits and misses are measured.
+    std::vector<MArea> collisionProbes(size_t count) {
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<double> px(0, 1900);
+        std::uniform_real_distribution<double> py(0, 1100);
+        std::vector<MArea> probes;
+        probes.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            MArea probe = BenchUtils::createPolygon(0, 0, 80, 60, 24, -1);
+            probe.placeInPosition(px(rng), py(rng));
+            probes.push_back(probe);
+        }
+        return probes;
+    }
+}
+
+static void BM_Bin_IsCollision(benchmark::State& state) {
+    Bin bin = polygonBin(static_cast<size_t>(state.range(0)));
+    std::vector<MArea> probes = collisionProbes(256);
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(BinBenchmarkAccess::isCollision(bin, probes[i++ % probes.size()]));
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["placed"] = static_cast<double>(bin.getNPlaced());
+}
+BENCHMARK(BM_Bin_IsCollision)->Arg(16)->Arg(64)->Arg(256);
+
+// Broad-phase query cost of the spatial index built by the stages' insertions, after the given
+// number of compress-like passes of unit moves (second argument), against the same layout indexed
+// by the restoring constructor (third argument 1), as after deserialization.
+static void BM_Bin_SpatialIndexQuery(benchmark::State& state) {
+    Bin filled = polygonBin(static_cast<size_t>(state.range(0)));
+    BinBenchmarkAccess::churnSpatialIndex(filled, static_cast<size_t>(state.range(1)));
+    Bin bin = state.range(2) ? Bin(kBinDimension, filled.getConfig(), filled.getPlacedPieces(), filled.getFreeRectangles())
+                             : std::move(filled);
+    std::vector<MArea> probes = collisionProbes(256);
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(BinBenchmarkAccess::querySpatialIndex(bin, probes[i++ % probes.size()].getBoundingBox2D()));
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["placed"] = static_cast<double>(bin.getNPlaced());
+}
+BENCHMARK(BM_Bin_SpatialIndexQuery)->Args({256, 0, 0})->Args({256, 8, 0})->Args({256, 0, 1});
+
+// Cost of moving one entry by a unit step and back, the index work of a compress step.
+static void BM_Bin_SpatialIndexUpdate(benchmark::State& state) {
+    Bin bin = polygonBin(static_cast<size_t>(state.range(0)));
+    std::vector<Rectangle2D> boxes;
+    for (const auto& piece : bin.getPlacedPieces()) {
+        boxes.push_back(piece.getBoundingBox2D());
+    }
+    size_t i = 0;
+    for (auto _ : state) {
+        size_t index = i++ % boxes.size();
+        BinBenchmarkAccess::updateSpatialIndex(bin, index, BinBenchmarkAccess::shifted(boxes[index], 0, -1));
+        BinBenchmarkAccess::updateSpatialIndex(bin, index, boxes[index]);
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["placed"] = static_cast<double>(bin.getNPlaced());
+}
+BENCHMARK(BM_Bin_SpatialIndexUpdate)->Arg(256);
+
+static void BM_Bin_FindWhereToPlace(benchmark::State& state) {
+    Bin bin(kBinDimension);
+    BinBenchmarkAccess::splitRandomBoxes(bin, static_cast<size_t>(state.range(0)), 20, 200);
+    MArea piece = BenchUtils::createRect(0, 0, 30, 20, -1);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(bin.findWhereToPlace(piece, false));
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["freeRectangles"] = static_cast<double>(BinBenchmarkAccess::freeRectangles(bin).size());
+}
+BENCHMARK(BM_Bin_FindWhereToPlace)->Arg(16)->Arg(64)->Arg(256);
+
+// The free-rectangle list is restored from a snapshot on every iteration, so the
+// reported time includes one vector copy on top of the split itself.
+static void BM_Bin_ComputeFreeRectangles(benchmark::State& state) {
+    Bin bin(kBinDimension);
+    BinBenchmarkAccess::splitRandomBoxes(bin, static_cast<size_t>(state.range(0)), 20, 200);
+    const auto snapshot = BinBenchmarkAccess::freeRectangles(bin);
+    // A small box in the corner of the largest free rectangle overlaps several of them.
+    MPointDouble corner = snapshot.front().min_corner();
+    Rectangle2D placedBB(corner, MPointDouble(corner.x() + 20, corner.y() + 20));
+    for (auto _ : state) {
+        BinBenchmarkAccess::freeRectangles(bin) = snapshot;
+        BinBenchmarkAccess::computeFreeRectangles(bin, placedBB);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["freeRectangles"] = static_cast<double>(snapshot.size());
+}
+BENCHMARK(BM_Bin_ComputeFreeRectangles)->Arg(16)->Arg(64)->Arg(256);
+
+static void BM_Bin_EliminateNonMaximal(benchmark::State& state) {
+    Bin bin(kBinDimension);
+    BinBenchmarkAccess::splitRandomBoxes(bin, static_cast<size_t>(state.range(0)), 20, 200);
+    // Split without eliminating to obtain a realistic list containing non-maximal rectangles.
+    MPointDouble corner = BinBenchmarkAccess::freeRectangles(bin).front().min_corner();
+    BinBenchmarkAccess::computeFreeRectangles(bin, Rectangle2D(corner, MPointDouble(corner.x() + 20, corner.y() + 20)));
+    const auto snapshot = BinBenchmarkAccess::freeRectangles(bin);
+    for (auto _ : state) {
+        BinBenchmarkAccess::freeRectangles(bin) = snapshot;
+        BinBenchmarkAccess::eliminateNonMaximal(bin);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["freeRectangles"] = static_cast<double>(snapshot.size());
+}
+BENCHMARK(BM_Bin_EliminateNonMaximal)->Arg(16)->Arg(64)->Arg(256);
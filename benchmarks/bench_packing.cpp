@@ -0,0 +1,120 @@
+#include <benchmark/benchmark.h>
+#include "BenchUtils.h"
+#include "core/BinPacking.h"
+#include "utils/Utils.h"
+#include "utils/WorkloadGenerator.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Macrobenchmarks: full BinPacking::pack runs over the sample corpus and generated jobs.
+// This file also provides the benchmark entry point, because the sample benchmarks are
+// registered at runtime from the contents of the samples directory.
+
+#ifndef PACKING_SAMPLES_DIR
+#define PACKING_SAMPLES_DIR "samples"
+#endif
+
+namespace {
+
+void runPack(benchmark::State& state, const std::vector<MArea>& pieces, const Rectangle2D& binDimension, bool useParallel) {
+    size_t nBins = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::vector<MArea> toPack = pieces; // pack sorts its input in place
+        state.ResumeTiming();
+
+        std::vector<Bin> bins = BinPacking::pack(toPack, binDimension, useParallel);
+        nBins = bins.size();
+        benchmark::DoNotOptimize(bins.data());
+    }
+    state.counters["pieces"] = static_cast<double>(pieces.size());
+    state.counters["bins"] = static_cast<double>(nBins);
+}
+
+void registerSampleBenchmarks(const std::string& samplesDir) {
+    std::vector<std::filesystem::path> files;
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(samplesDir, ec)) {
+        if (entry.is_regular_file() && entry.path().extension() == ".txt") {
+            files.push_back(entry.path());
+        }
+    }
+    if (ec) {
+        std::cerr << "Warning: Could not read samples directory " << samplesDir << ": " << ec.message() << std::endl;
+        return;
+    }
+    std::sort(files.begin(), files.end());
+
+    for (const auto& file : files) {
+        auto loadResult = Utils::loadPieces(file.string());
+        if (!loadResult) {
+            continue;
+        }
+        std::string name = file.stem().string();
+        for (bool useParallel : {false, true}) {
+            benchmark::RegisterBenchmark(
+                ("BM_Pack/" + name + (useParallel ? "/parallel" : "/sequential")).c_str(),
+                [pieces = loadResult->pieces, binDimension = loadResult->binDimension, useParallel](benchmark::State& state) {
+                    runPack(state, pieces, binDimension, useParallel);
+                })
+                ->Unit(benchmark::kMillisecond)
+                ->UseRealTime();
+        }
+    }
+}
+
+} // namespace
+
+// Synthetic jobs from the workload generator; the argument is the number of pieces.
+static void BM_Pack_GeneratedRectangles(benchmark::State& state) {
+    WorkloadGenerator::Options options;
+    options.pieces = static_cast<size_t>(state.range(0));
+    options.convexWeight = options.concaveWeight = 0.0;
+    auto instance = WorkloadGenerator::generate(options);
+    runPack(state, WorkloadGenerator::toPieces(instance), instance.binDimension, false);
+}
+BENCHMARK(BM_Pack_GeneratedRectangles)->Arg(100)->Arg(300)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+static void BM_Pack_GeneratedMixed(benchmark::State& state) {
+    WorkloadGenerator::Options options;
+    options.pieces = static_cast<size_t>(state.range(0));
+    options.withHolesWeight = 0.5;
+    auto instance = WorkloadGenerator::generate(options);
+    runPack(state, WorkloadGenerator::toPieces(instance), instance.binDimension, false);
+}
+BENCHMARK(BM_Pack_GeneratedMixed)->Arg(100)->Arg(300)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// Usage: packing_bench [--samples_dir=<dir>] [Google Benchmark flags]
+// The samples directory can also be set through the PACKING_SAMPLES_DIR environment variable.
+int main(int argc, char** argv) {
+    std::string samplesDir = PACKING_SAMPLES_DIR;
+    if (const char* env = std::getenv("PACKING_SAMPLES_DIR")) {
+        samplesDir = env;
+    }
+
+    const char* samplesFlag = "--samples_dir=";
+    std::vector<char*> args;
+    for (int i = 0; i < argc; ++i) {
+        if (std::strncmp(argv[i], samplesFlag, std::strlen(samplesFlag)) == 0) {
+            samplesDir = argv[i] + std::strlen(samplesFlag);
+        } else {
+            args.push_back(argv[i]);
+        }
+    }
+    int benchArgc = static_cast<int>(args.size());
+
+    registerSampleBenchmarks(samplesDir);
+
+    benchmark::Initialize(&benchArgc, args.data());
+    if (benchmark::ReportUnrecognizedArguments(benchArgc, args.data())) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,61 @@
+#include <benchmark/benchmark.h>
+#include "BenchUtils.h"
+#include "primitives/MArea.h"
+#include "primitives/MVector.h"
+
+// Microbenchmarks for the MArea primitives. The argument is the number of vertices of the piece.
+
+static void BM_MArea_Move(benchmark::State& state) {
+    MArea piece = BenchUtils::createPolygon(0, 0, 100, 60, static_cast<int>(state.range(0)), 1);
+    MVector forward(1.0, 1.0);
+    MVector backward = forward.inverse();
+    for (auto _ : state) {
+        piece.move(forward);
+        piece.move(backward);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+BENCHMARK(BM_MArea_Move)->RangeMultiplier(4)->Range(4, 1024);
+
+static void BM_MArea_Rotate(benchmark::State& state) {
+    MArea piece = BenchUtils::createPolygon(0, 0, 100, 60, static_cast<int>(state.range(0)), 1);
+    for (auto _ : state) {
+        piece.rotate(90);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MArea_Rotate)->RangeMultiplier(4)->Range(4, 1024);
+
+static void BM_MArea_GetBoundingBox2D(benchmark::State& state) {
+    MArea piece = BenchUtils::createPolygon(0, 0, 100, 60, static_cast<int>(state.range(0)), 1);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(piece.getBoundingBox2D());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MArea_GetBoundingBox2D)->RangeMultiplier(4)->Range(4, 1024);
+
+static void BM_MArea_Intersection_Overlapping(benchmark::State& state) {
+    int nVertices = static_cast<int>(state.range(0));
+    MArea a = BenchUtils::createPolygon(0, 0, 100, 60, nVertices, 1);
+    MArea b = BenchUtils::createPolygon(50, 30, 100, 60, nVertices, 2);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a.intersection(b));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MArea_Intersection_Overlapping)->RangeMultiplier(4)->Range(4, 1024);
+
+// Bounding boxes overlap but the shapes do not: the worst case for the narrow phase.
+static void BM_MArea_Intersection_NearMiss(benchmark::State& state) {
+    int nVertices = static_cast<int>(state.range(0));
+    MArea a = BenchUtils::createPolygon(0, 0, 100, 100, nVertices, 1);
+    MArea b = BenchUtils::createPolygon(90, 90, 100, 100, nVertices, 2);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a.intersection(b));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MArea_Intersection_NearMiss)->RangeMultiplier(4)->Range(4, 1024);
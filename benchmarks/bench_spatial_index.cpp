@@ -0,0 +1,119 @@
+#include <benchmark/benchmark.h>
+#include "core/SpatialIndex.h"
+#include <cmath>
+#include <random>
+
+// Microbenchmarks of the broad-phase backends of SpatialIndex. The arguments are the BroadPhase
+// (0 for Auto), the number of boxes and the layout: 0 for boxes of similar sizes, 1 for the same
+// with one box in ten four times as large in each direction, 2 with one box in fifty sixteen
+// times as large.
+
+namespace {
+    const Rectangle2D kBounds(MPointDouble(0, 0), MPointDouble(2000, 1200));
+
+    Rectangle2D box(double x, double y, double w, double h) {
+        return Rectangle2D(MPointDouble(x, y), MPointDouble(x + w, y + h));
+    }
+
+    // Boxes on a jittered lattice filling the bounds, as in a packed bin.
+    std::vector<Rectangle2D> layout(size_t n, int64_t mix) {
+        double width = RectangleUtils::getWidth(kBounds);
+        double height = RectangleUtils::getHeight(kBounds);
+        size_t cols = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(n) * width / height)));
+        size_t rows = (n + cols - 1) / cols;
+        double cw = width / static_cast<double>(cols);
+        double ch = height / static_cast<double>(rows);
+        std::mt19937 rng(11);
+        std::uniform_real_distribution<double> fill(0.6, 0.95);
+        std::vector<Rectangle2D> boxes;
+        boxes.reserve(n);
+        for (size_t i = 0; i < n; ++i) {
+            double x = cw * static_cast<double>(i % cols);
+            double y = ch * static_cast<double>(i / cols);
+            double scale = mix == 1 && i % 10 == 0 ? 4 : mix == 2 && i % 50 == 0 ? 16 : 1;
+            boxes.push_back(box(x, y, std::min(cw * scale * fill(rng), width - x), std::min(ch * scale * fill(rng), height - y)));
+        }
+        return boxes;
+    }
+
+    // Probes of the size of a small box, spread over the bounds.
+    std::vector<Rectangle2D> probes(size_t n, size_t count) {
+        double side = std::sqrt(RectangleUtils::getWidth(kBounds) * RectangleUtils::getHeight(kBounds) / static_cast<double>(n));
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<double> px(0, RectangleUtils::getWidth(kBounds) - side);
+        std::uniform_real_distribution<double> py(0, RectangleUtils::getHeight(kBounds) - side);
+        std::vector<Rectangle2D> result;
+        result.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            result.push_back(box(px(rng), py(rng), side * 0.8, side * 0.8));
+        }
+        return result;
+    }
+
+    SpatialIndex filledIndex(BroadPhase broadPhase, const std::vector<Rectangle2D>& boxes) {
+        SpatialIndex index(kBounds, broadPhase);
+        for (size_t i = 0; i < boxes.size(); ++i) {
+            index.insert(i, boxes[i]);
+        }
+        return index;
+    }
+
+    void backendArgs(benchmark::internal::Benchmark* b) {
+        for (int broadPhase = 0; broadPhase <= static_cast<int>(BroadPhase::RTreeRStar); ++broadPhase) {
+            for (int n : {16, 64, 256, 2048, 16384}) {
+                for (int mix : {0, 1, 2}) {
+                    b->Args({broadPhase, n, mix});
+                }
+            }
+        }
+    }
+
+    void label(benchmark::State& state, const SpatialIndex& index) {
+        state.SetLabel(broadPhaseName(index.current()));
+    }
+}
+
+static void BM_SpatialIndex_Query(benchmark::State& state) {
+    size_t n = static_cast<size_t>(state.range(1));
+    std::vector<Rectangle2D> boxes = layout(n, state.range(2));
+    SpatialIndex index = filledIndex(static_cast<BroadPhase>(state.range(0)), boxes);
+    std::vector<Rectangle2D> queries = probes(n, 256);
+    size_t i = 0;
+    for (auto _ : state) {
+        size_t found = 0;
+        index.query(queries[i++ % queries.size()], [&found](size_t, const Rectangle2D&) { found++; });
+        benchmark::DoNotOptimize(found);
+    }
+    state.SetItemsProcessed(state.iterations());
+    label(state, index);
+}
+BENCHMARK(BM_SpatialIndex_Query)->Apply(backendArgs);
+
+// A unit step down and back, as compress moves a placed piece.
+static void BM_SpatialIndex_Update(benchmark::State& state) {
+    size_t n = static_cast<size_t>(state.range(1));
+    std::vector<Rectangle2D> boxes = layout(n, state.range(2));
+    SpatialIndex index = filledIndex(static_cast<BroadPhase>(state.range(0)), boxes);
+    size_t i = 0;
+    for (auto _ : state) {
+        size_t k = i++ % n;
+        const Rectangle2D& b = boxes[k];
+        index.update(k, box(b.min_corner().x(), b.min_corner().y() - 1, RectangleUtils::getWidth(b), RectangleUtils::getHeight(b)));
+        index.update(k, b);
+    }
+    state.SetItemsProcessed(state.iterations() * 2);
+    label(state, index);
+}
+BENCHMARK(BM_SpatialIndex_Update)->Apply(backendArgs);
+
+// Filling an index box by box, as the stages place pieces.
+static void BM_SpatialIndex_Insert(benchmark::State& state) {
+    size_t n = static_cast<size_t>(state.range(1));
+    std::vector<Rectangle2D> boxes = layout(n, state.range(2));
+    for (auto _ : state) {
+        SpatialIndex index = filledIndex(static_cast<BroadPhase>(state.range(0)), boxes);
+        benchmark::DoNotOptimize(index.size());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(n));
+}
+BENCHMARK(BM_SpatialIndex_Insert)->Apply(backendArgs);
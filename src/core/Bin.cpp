@@ -1,6 +1,9 @@
 #include "Bin.h"
 #include "primitives/Rectangle.h" // For RectangleUtils
 #include "core/Constants.h"
+#include "utils/Trace.h"
+#include "core/Validation.h"
+#include "primitives/FixedPoint.h"
 #include <limits>
 #include <algorithm>
 #include <numeric>
@@ -16,35 +19,137 @@ namespace TestUtils {
     }
 }
 
-Bin::Bin(const Rectangle2D& dimension) : dimension(dimension) {
+Bin::Bin(const Rectangle2D& dimension, const PackingConfig& config) :
+    dimension(dimension),
+    config(config),
+    memoryTracker(std::make_unique<Memory::Tracker>(stats, currentStage)),
+    freeRectangles(trackedAllocator<Rectangle2D>(Stats::MemoryCategory::FreeRectangles)),
+    spatialIndex(dimension, config.broadPhase, trackedAllocator<char>(Stats::MemoryCategory::RTree))
+{
     freeRectangles.push_back(dimension);
 }
 
+Bin::Bin(const Rectangle2D& dimension, const PackingConfig& config, std::vector<MArea> placedPieces,
+         const std::vector<Rectangle2D>& freeRectangles) :
+    dimension(dimension),
+    config(config),
+    memoryTracker(std::make_unique<Memory::Tracker>(stats, currentStage)),
+    placedPieces(std::move(placedPieces)),
+    freeRectangles(freeRectangles.begin(), freeRectangles.end(), trackedAllocator<Rectangle2D>(Stats::MemoryCategory::FreeRectangles)),
+    spatialIndex(dimension, config.broadPhase, trackedAllocator<char>(Stats::MemoryCategory::RTree))
+{
+    for (size_t i = 0; i < this->placedPieces.size(); ++i) {
+        spatialIndex.insert(i, this->placedPieces[i].getBoundingBox2D());
+    }
+    trackPlacedPieces();
+}
+
 Bin::Bin(const Bin& other) :
     dimension(other.dimension),
+    config(other.config),
+    stats(other.stats),
+    currentStage(other.currentStage),
+    memoryTracker(std::make_unique<Memory::Tracker>(stats, currentStage)),
     placedPieces(other.placedPieces),
-    freeRectangles(other.freeRectangles),
-    placedPiecesRTree(other.placedPiecesRTree)
+    freeRectangles(other.freeRectangles, trackedAllocator<Rectangle2D>(Stats::MemoryCategory::FreeRectangles)),
+    spatialIndex(other.spatialIndex, trackedAllocator<char>(Stats::MemoryCategory::RTree))
     // collisionMutex is not copied, a new one is default-initialized.
+    // The progress reporter and cancellation token belong to the run and are not copied either.
 {
+    trackPlacedPieces();
 }
 
 Bin& Bin::operator=(const Bin& other) {
     if (this == &other) {
         return *this;
     }
-    dimension = other.dimension;
-    placedPieces = other.placedPieces;
-    freeRectangles = other.freeRectangles;
-    placedPiecesRTree = other.placedPiecesRTree;
-    // collisionMutex is not copied.
+    // Copy and swap: the copy allocates through a tracker of its own, which this bin then takes over.
+    Bin copy(other);
+    copy.setProgress(progress, cancellation);
+    swap(copy);
     return *this;
 }
 
+Bin::Bin(Bin&& other) noexcept :
+    dimension(other.dimension),
+    config(other.config),
+    stats(std::move(other.stats)),
+    currentStage(other.currentStage),
+    memoryTracker(std::move(other.memoryTracker)),
+    // Moving a container moves its allocator, which points to the tracker taken over above.
+    placedPieces(std::move(other.placedPieces)),
+    freeRectangles(std::move(other.freeRectangles)),
+    spatialIndex(std::move(other.spatialIndex)),
+    progress(other.progress),
+    cancellation(other.cancellation)
+{
+    memoryTracker->attach(stats, currentStage);
+}
+
+Bin& Bin::operator=(Bin&& other) noexcept {
+    swap(other); // The old state of this bin is released when other is destroyed.
+    return *this;
+}
+
+void Bin::swap(Bin& other) noexcept {
+    using std::swap;
+    swap(dimension, other.dimension);
+    swap(config, other.config);
+    swap(stats, other.stats);
+    swap(currentStage, other.currentStage);
+    swap(memoryTracker, other.memoryTracker);
+    // The tracking allocators propagate on swap, so each container goes along with its tracker.
+    placedPieces.swap(other.placedPieces);
+    freeRectangles.swap(other.freeRectangles);
+    spatialIndex.swap(other.spatialIndex);
+    swap(progress, other.progress);
+    swap(cancellation, other.cancellation);
+    if (memoryTracker) {
+        memoryTracker->attach(stats, currentStage);
+    }
+    if (other.memoryTracker) {
+        other.memoryTracker->attach(other.stats, other.currentStage);
+    }
+}
+
+void Bin::enterStage(Stats::Stage stage) {
+    currentStage = stage;
+    memoryTracker->publish();
+    reportProgress();
+}
+
+void Bin::setProgress(Progress::Reporter* reporter, const Progress::CancellationToken* cancellation) {
+    this->progress = reporter;
+    this->cancellation = cancellation;
+}
+
+void Bin::reportProgress() {
+    if (progress && progress->due()) {
+        progress->report(placedPieces.size(), getOccupiedArea(), currentStage);
+    }
+}
+
+void Bin::recordPlacementLatency(std::chrono::steady_clock::time_point start, const MArea& piece) {
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+    stats.placementLatency(currentStage, Stats::vertexBucket(piece.getVertexCount())).record(static_cast<uint64_t>(elapsed.count()));
+}
+
+void Bin::trackPlacedPieces() {
+    size_t bytes = placedPieces.capacity() * sizeof(MArea);
+    for (const auto& piece : placedPieces) {
+        bytes += piece.getMemoryUsage();
+    }
+    memoryTracker->set(Stats::MemoryCategory::PlacedPieces, bytes);
+}
+
 const std::vector<MArea>& Bin::getPlacedPieces() const {
     return placedPieces;
 }
 
+std::vector<Rectangle2D> Bin::getFreeRectangles() const {
+    return std::vector<Rectangle2D>(freeRectangles.begin(), freeRectangles.end());
+}
+
 size_t Bin::getNPlaced() const {
     return placedPieces.size();
 }
@@ -65,25 +170,58 @@ double Bin::getEmptyArea() const {
     return binArea - getOccupiedArea();
 }
 
+const PackingConfig& Bin::getConfig() const {
+    return config;
+}
+
+const Stats::BinStats& Bin::getStats() const {
+    return stats;
+}
+
 bool Bin::isCollision(const MArea& piece, std::optional<size_t> ignoredPieceIndex) {
-    // 1. Broad phase: Query the R-tree to find pieces whose bounding boxes intersect with the new piece's bounding box.
-    std::vector<RTreeValue> candidates;
-    placedPiecesRTree.query(boost::geometry::index::intersects(piece.getBoundingBox2D()), std::back_inserter(candidates));
+    bool collides = isCollisionIndexed(piece, ignoredPieceIndex);
+#if PACKING_ENABLE_VALIDATION
+    if (Validation::isEnabled()) {
+        Validation::checkCollision(piece, placedPieces, ignoredPieceIndex, dimension, collides, currentStage);
+    }
+#endif
+    return collides;
+}
+
+bool Bin::isCollisionIndexed(const MArea& piece, std::optional<size_t> ignoredPieceIndex) {
+    // 1. Broad phase: Query the spatial index to find pieces whose bounding boxes intersect with the new piece's bounding box.
+    // The candidates are streamed into a stack buffer with the area of their overlap with the piece.
+    Rectangle2D pieceBB = piece.getBoundingBox2D();
+    CandidateBuffer candidates(CandidateBuffer::allocator_type(trackedAllocator<Candidate>(Stats::MemoryCategory::Temporary)));
+    size_t found = 0;
+    spatialIndex.query(pieceBB, [&](size_t index, const Rectangle2D& box) {
+        // If we are moving a piece, we must ignore a collision with itself.
+        if (ignoredPieceIndex && index == *ignoredPieceIndex) {
+            return;
+        }
+        found++;
+        double width = std::min(RectangleUtils::getMaxX(pieceBB), RectangleUtils::getMaxX(box)) -
+                       std::max(RectangleUtils::getX(pieceBB), RectangleUtils::getX(box));
+        double height = std::min(RectangleUtils::getMaxY(pieceBB), RectangleUtils::getMaxY(box)) -
+                        std::max(RectangleUtils::getY(pieceBB), RectangleUtils::getY(box));
+        candidates.emplace_back(width * height, index);
+    });
+    Stats::Counters& c = counters();
+    c.rtreeQueries++;
+    c.broadPhaseCandidates += found;
 
     if (candidates.empty()) {
         return false; // No overlapping bounding boxes means no collision.
     }
 
-    // 2. Narrow phase: For the few candidates found, perform a precise geometric intersection test.
+    // 2. Narrow phase: the precise test stops at the first hit, so the candidates most likely to
+    // collide, those overlapping the piece the most, are tested first.
+    if (candidates.size() > 1) {
+        std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) { return a.first > b.first; });
+    }
     for (const auto& candidate : candidates) {
-        size_t candidateIndex = candidate.second;
-
-        // If we are moving a piece, we must ignore a collision with itself.
-        if (ignoredPieceIndex && candidateIndex == *ignoredPieceIndex) {
-            continue;
-        }
-
-        if (piece.intersection(placedPieces[candidateIndex])) {
+        c.narrowPhaseTests++;
+        if (intersects(piece, placedPieces[candidate.second])) {
             return true; // Found a definite collision.
         }
     }
@@ -130,9 +268,13 @@ Bin::Placement Bin::findWhereToPlace(const MArea& piece, bool useParallel) {
     if (useParallel && !g_parallelism_disabled_for_tests && freeRectangles.size() > 250) {
 #if __cpp_lib_parallel_algorithm >= 201603L
         // Use parallel algorithm if supported (C++17 and later)
+        TRACE_SCOPE("findWhereToPlace.parallel", "freeRectangles", static_cast<int64_t>(freeRectangles.size()));
         std::vector<int> indices(freeRectangles.size());
         std::iota(indices.begin(), indices.end(), 0);
-        std::for_each(std::execution::par, indices.begin(), indices.end(), checkPlacement);
+        std::for_each(std::execution::par, indices.begin(), indices.end(), [&](int i) {
+            TRACE_SCOPE("checkPlacement", "rectIndex", i);
+            checkPlacement(i);
+        });
 #else
         // Fallback to sequential if parallel algorithms are not supported
         for (int i = static_cast<int>(freeRectangles.size()) - 1; i >= 0; --i) {
@@ -149,13 +291,40 @@ Bin::Placement Bin::findWhereToPlace(const MArea& piece, bool useParallel) {
 }
 
 std::vector<MArea> Bin::boundingBoxPacking(std::vector<MArea>& piecesToPlace, bool useParallel) {
+    std::vector<size_t> order(piecesToPlace.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::vector<size_t> notPlacedIndices = boundingBoxPacking(piecesToPlace, order, useParallel);
+
     std::vector<MArea> notPlacedPieces;
+    notPlacedPieces.reserve(notPlacedIndices.size());
+    for (size_t i : notPlacedIndices) {
+        notPlacedPieces.push_back(piecesToPlace[i]);
+    }
+    std::vector<MArea> sorted;
+    sorted.reserve(order.size());
+    for (size_t i : order) {
+        sorted.push_back(std::move(piecesToPlace[i]));
+    }
+    piecesToPlace = std::move(sorted);
+    return notPlacedPieces;
+}
 
-    std::sort(piecesToPlace.begin(), piecesToPlace.end(), [](const MArea& a, const MArea& b) {
-        return a.getArea() > b.getArea();
+std::vector<size_t> Bin::boundingBoxPacking(const std::vector<MArea>& pieces, std::vector<size_t>& indices, bool useParallel) {
+    TRACE_SCOPE("boundingBoxPacking");
+    enterStage(Stats::Stage::BoundingBoxPacking);
+    std::vector<size_t> notPlacedPieces;
+
+    std::sort(indices.begin(), indices.end(), [&pieces](size_t a, size_t b) {
+        return pieces[a].getArea() > pieces[b].getArea();
     });
 
-    for (const auto& piece : piecesToPlace) {
+    for (size_t index : indices) {
+        const MArea& piece = pieces[index];
+        if (isCancelled()) {
+            notPlacedPieces.push_back(index);
+            continue;
+        }
+        auto start = std::chrono::steady_clock::now();
         Placement placement = findWhereToPlace(piece, useParallel);
 
         if (placement.rectIndex != -1) {
@@ -167,6 +336,7 @@ std::vector<MArea> Bin::boundingBoxPacking(std::vector<MArea>& piecesToPlace, bo
             }
 
             placedPiece.placeInPosition(RectangleUtils::getX(freeRect), RectangleUtils::getY(freeRect));
+            snap(placedPiece);
 
             if (!isCollision(placedPiece)) {
                 Rectangle2D pieceBB = placedPiece.getBoundingBox2D();
@@ -174,20 +344,22 @@ std::vector<MArea> Bin::boundingBoxPacking(std::vector<MArea>& piecesToPlace, bo
                 eliminateNonMaximal();
 
                 placedPieces.push_back(placedPiece);
-                placedPiecesRTree.insert({pieceBB, placedPieces.size() - 1});
+                trackPlacedPieces();
+                spatialIndex.insert(placedPieces.size() - 1, pieceBB);
+                reportProgress();
             } else {
-                notPlacedPieces.push_back(piece);
+                notPlacedPieces.push_back(index);
             }
         } else {
-            notPlacedPieces.push_back(piece);
+            notPlacedPieces.push_back(index);
         }
+        recordPlacementLatency(start, piece);
     }
     return notPlacedPieces;
 }
 
 void Bin::computeFreeRectangles(const Rectangle2D& justPlacedPieceBB) {
-    std::vector<Rectangle2D> nextFreeRectangles;
-    const double epsilon = 1e-9;
+    TrackedVector<Rectangle2D> nextFreeRectangles(trackedAllocator<Rectangle2D>(Stats::MemoryCategory::Temporary));
 
     for (const auto& freeR : freeRectangles) {
         if (!RectangleUtils::intersects(freeR, justPlacedPieceBB)) {
@@ -195,24 +367,26 @@ void Bin::computeFreeRectangles(const Rectangle2D& justPlacedPieceBB) {
         } else {
             Rectangle2D rIntersection = RectangleUtils::createIntersection(freeR, justPlacedPieceBB);
             double topHeight = RectangleUtils::getMaxY(freeR) - RectangleUtils::getMaxY(rIntersection);
-            if (topHeight > epsilon) {
+            if (isPositive(topHeight)) {
                 nextFreeRectangles.emplace_back(MPointDouble(RectangleUtils::getX(freeR), RectangleUtils::getMaxY(rIntersection)), MPointDouble(RectangleUtils::getMaxX(freeR), RectangleUtils::getMaxY(freeR)));
             }
             double bottomHeight = RectangleUtils::getY(rIntersection) - RectangleUtils::getY(freeR);
-            if (bottomHeight > epsilon) {
+            if (isPositive(bottomHeight)) {
                 nextFreeRectangles.emplace_back(MPointDouble(RectangleUtils::getX(freeR), RectangleUtils::getY(freeR)), MPointDouble(RectangleUtils::getMaxX(freeR), RectangleUtils::getY(rIntersection)));
             }
             double leftWidth = RectangleUtils::getX(rIntersection) - RectangleUtils::getX(freeR);
-            if (leftWidth > epsilon) {
+            if (isPositive(leftWidth)) {
                 nextFreeRectangles.emplace_back(MPointDouble(RectangleUtils::getX(freeR), RectangleUtils::getY(freeR)), MPointDouble(RectangleUtils::getX(rIntersection), RectangleUtils::getMaxY(freeR)));
             }
             double rightWidth = RectangleUtils::getMaxX(freeR) - RectangleUtils::getMaxX(rIntersection);
-            if (rightWidth > epsilon) {
+            if (isPositive(rightWidth)) {
                 nextFreeRectangles.emplace_back(MPointDouble(RectangleUtils::getMaxX(rIntersection), RectangleUtils::getY(freeR)), MPointDouble(RectangleUtils::getMaxX(freeR), RectangleUtils::getMaxY(freeR)));
             }
         }
     }
     freeRectangles = nextFreeRectangles;
+    Stats::Counters& c = counters();
+    c.freeRectanglesHighWater = std::max<uint64_t>(c.freeRectanglesHighWater, freeRectangles.size());
 }
 
 void Bin::eliminateNonMaximal() {
@@ -235,104 +409,105 @@ void Bin::eliminateNonMaximal() {
 }
 
 void Bin::compress(bool useParallel) {
+    TRACE_SCOPE("compress");
+    enterStage(Stats::Stage::Compress);
     if (placedPieces.empty()) {
         return;
     }
 
     bool moved_in_pass = true;
-    while (moved_in_pass) {
+    while (moved_in_pass && !isCancelled()) {
         moved_in_pass = false;
         for (size_t i = 0; i < placedPieces.size(); ++i) {
+            auto start = std::chrono::steady_clock::now();
             if (compressPiece(i, MVector(-1.0, -1.0))) {
                 moved_in_pass = true;
             }
+            recordPlacementLatency(start, placedPieces[i]);
+            reportProgress();
         }
     }
 }
 
-bool Bin::compressPiece(size_t pieceIndex, const MVector& vector) {
-    if (vector.getX() == 0 && vector.getY() == 0) {
-        return false;
-    }
-
-    MArea& pieceToMove = placedPieces[pieceIndex];
-    RTreeValue rtreeEntry = {pieceToMove.getBoundingBox2D(), pieceIndex};
-
-    // Temporarily remove the piece from the R-tree to avoid self-collision.
-    placedPiecesRTree.remove(rtreeEntry);
-
+int Bin::slide(MArea& piece, const MVector& vector, std::optional<size_t> ignoredPieceIndex) {
     int total_moves = 0;
     bool moved_in_iter = true;
-    while (moved_in_iter) {
+    while (moved_in_iter && !isCancelled()) {
         moved_in_iter = false;
 
         if (vector.getY() != 0) {
             MVector u_y(0, vector.getY());
-            pieceToMove.move(u_y);
-            if (pieceToMove.isInside(this->dimension) && !isCollision(pieceToMove)) {
+            counters().compressSteps++;
+            piece.move(u_y);
+            snap(piece);
+            if (piece.isInside(this->dimension) && !isCollision(piece, ignoredPieceIndex)) {
                 moved_in_iter = true;
                 total_moves++;
             } else {
-                pieceToMove.move(u_y.inverse());
+                piece.move(u_y.inverse());
+                snap(piece);
             }
         }
 
         if (vector.getX() != 0) {
             MVector u_x(vector.getX(), 0);
-            pieceToMove.move(u_x);
-            if (pieceToMove.isInside(this->dimension) && !isCollision(pieceToMove)) {
+            counters().compressSteps++;
+            piece.move(u_x);
+            snap(piece);
+            if (piece.isInside(this->dimension) && !isCollision(piece, ignoredPieceIndex)) {
                 moved_in_iter = true;
                 total_moves++;
             } else {
-                pieceToMove.move(u_x.inverse());
+                piece.move(u_x.inverse());
+                snap(piece);
             }
         }
     }
+    return total_moves;
+}
 
-    // Add the piece back to the R-tree in its new final position.
-    placedPiecesRTree.insert({pieceToMove.getBoundingBox2D(), pieceIndex});
+bool Bin::compressPiece(size_t pieceIndex, const MVector& vector) {
+    if (vector.getX() == 0 && vector.getY() == 0) {
+        return false;
+    }
 
+    // The piece keeps its index entry while it slides; isCollision skips it, and the entry is
+    // updated in place once the piece has stopped.
+    MArea& pieceToMove = placedPieces[pieceIndex];
+    int total_moves = slide(pieceToMove, vector, pieceIndex);
+    if (total_moves > 0) {
+        spatialIndex.update(pieceIndex, pieceToMove.getBoundingBox2D());
+    }
     return total_moves > 0;
 }
 
 bool Bin::compressPiece_parallel_helper(MArea& piece, size_t pieceIndex) {
-    const MVector vector(-1.0, -1.0);
-    int total_moves = 0;
-    bool moved_in_iter = true;
-    while (moved_in_iter) {
-        moved_in_iter = false;
-
-        if (vector.getY() != 0) {
-            MVector u_y(0, vector.getY());
-            piece.move(u_y);
-            if (piece.isInside(this->dimension) && !isCollision(piece, pieceIndex)) {
-                moved_in_iter = true;
-                total_moves++;
-            } else {
-                piece.move(u_y.inverse());
-            }
-        }
-
-        if (vector.getX() != 0) {
-            MVector u_x(vector.getX(), 0);
-            piece.move(u_x);
-            if (piece.isInside(this->dimension) && !isCollision(piece, pieceIndex)) {
-                moved_in_iter = true;
-                total_moves++;
-            } else {
-                piece.move(u_x.inverse());
-            }
-        }
-    }
-    return total_moves > 0;
+    return slide(piece, MVector(-1.0, -1.0), pieceIndex) > 0;
 }
 
 std::vector<MArea> Bin::dropPieces(const std::vector<MArea>& piecesToDrop, bool useParallel) {
+    std::vector<size_t> order(piecesToDrop.size());
+    std::iota(order.begin(), order.end(), 0);
     std::vector<MArea> unplacedPieces;
+    for (size_t i : dropPieces(piecesToDrop, order, useParallel)) {
+        unplacedPieces.push_back(piecesToDrop[i]);
+    }
+    return unplacedPieces;
+}
+
+std::vector<size_t> Bin::dropPieces(const std::vector<MArea>& pieces, const std::vector<size_t>& indices, bool useParallel) {
+    TRACE_SCOPE("dropPieces");
+    enterStage(Stats::Stage::DropPieces);
+    std::vector<size_t> unplacedPieces;
 
-    for (const auto& pieceToTry : piecesToDrop) {
+    for (size_t index : indices) {
+        const MArea& pieceToTry = pieces[index];
+        auto start = std::chrono::steady_clock::now();
         bool wasPlaced = false;
         for (int angle : Constants::ROTATION_ANGLES) {
+            if (isCancelled()) {
+                break;
+            }
             MArea candidate = pieceToTry;
             if (angle > 0) {
                 candidate.rotate(static_cast<double>(angle));
@@ -340,14 +515,17 @@ std::vector<MArea> Bin::dropPieces(const std::vector<MArea>& piecesToDrop, bool
 
             if (auto placedPiece = dive(candidate, useParallel)) {
                 placedPieces.push_back(*placedPiece);
-                placedPiecesRTree.insert({placedPiece->getBoundingBox2D(), placedPieces.size() - 1});
+                trackPlacedPieces();
+                spatialIndex.insert(placedPieces.size() - 1, placedPiece->getBoundingBox2D());
+                reportProgress();
                 wasPlaced = true;
                 break;
             }
         }
         if (!wasPlaced) {
-            unplacedPieces.push_back(pieceToTry);
+            unplacedPieces.push_back(index);
         }
+        recordPlacementLatency(start, pieceToTry);
     }
     return unplacedPieces;
 }
@@ -363,40 +541,76 @@ std::optional<MArea> Bin::dive(MArea toDive, bool useParallel) {
         return std::nullopt;
     }
 
-    double dx = pieceWidth / Constants::DIVE_HORIZONTAL_DISPLACEMENT_FACTOR;
-    if (dx < 1e-9) dx = 1.0;
+    double dx = pieceWidth / config.diveHorizontalDisplacementFactor;
+    if (!isPositive(dx)) dx = 1.0;
 
-    for (double initialX = 0; initialX + pieceWidth <= binWidth + 1e-9; initialX += dx) {
+    for (double initialX = 0; fitsWithin(initialX + pieceWidth, binWidth); initialX += dx) {
+        if (isCancelled()) {
+            return std::nullopt;
+        }
         MArea tempPiece = toDive;
         tempPiece.placeInPosition(initialX, binHeight - pieceHeight);
+        snap(tempPiece);
+        counters().diveSlots++;
 
         if (!isCollision(tempPiece)) {
-            size_t tempIndex = placedPieces.size();
-            placedPieces.push_back(tempPiece);
-            compressPiece(tempIndex, MVector(0, -1.0));
-            MArea finalPiece = placedPieces.back();
-            placedPieces.pop_back();
-            return finalPiece;
+            return settle(tempPiece);
         }
     }
     
     MArea tempPiece = toDive;
     tempPiece.placeInPosition(binWidth - pieceWidth, binHeight - pieceHeight);
+    snap(tempPiece);
+    counters().diveSlots++;
     if (!isCollision(tempPiece)) {
-        size_t tempIndex = placedPieces.size();
-        placedPieces.push_back(tempPiece);
-        compressPiece(tempIndex, MVector(0, -1.0));
-        MArea finalPiece = placedPieces.back();
-        placedPieces.pop_back();
-        return finalPiece;
+        return settle(tempPiece);
     }
 
     return std::nullopt;
 }
 
+MArea Bin::settle(const MArea& piece) {
+    // The piece falls in one move to its first contact below, the floor or a placed piece found
+    // through the index, stopping short of a piece by the smallest gap that does not count as a
+    // collision. It is not indexed, so it cannot meet itself.
+    Rectangle2D box = piece.getBoundingBox2D();
+    Rectangle2D column(MPointDouble(RectangleUtils::getX(box), RectangleUtils::getY(dimension)),
+                       MPointDouble(RectangleUtils::getMaxX(box), RectangleUtils::getMaxY(box)));
+    double drop = RectangleUtils::getY(box) - RectangleUtils::getY(dimension);
+    const double gap = isFixedPoint() ? 1.0 / config.fixedPointScale : DROP_GAP;
+    size_t found = 0;
+    spatialIndex.query(column, [&](size_t index, const Rectangle2D&) {
+        found++;
+        drop = std::min(drop, piece.dropDistance(placedPieces[index]) - gap);
+    });
+    Stats::Counters& c = counters();
+    c.rtreeQueries++;
+    c.broadPhaseCandidates += found;
+
+    MArea finalPiece = piece;
+    if (isPositive(drop)) {
+        c.compressSteps++;
+        finalPiece.move(MVector(0, -drop));
+        snap(finalPiece);
+        if (finalPiece.isInside(this->dimension) && !isCollision(finalPiece)) {
+            return finalPiece;
+        }
+        finalPiece = piece; // Rounding put it in contact; fall back to unit steps.
+    }
+    slide(finalPiece, MVector(0, -1.0), std::nullopt);
+    return finalPiece;
+}
+
 bool Bin::moveAndReplace(size_t indexLimit) {
+    TRACE_SCOPE("moveAndReplace");
+    enterStage(Stats::Stage::MoveAndReplace);
     bool movement = false;
     for (int i = static_cast<int>(placedPieces.size()) - 1; i >= static_cast<int>(indexLimit); --i) {
+        if (isCancelled()) {
+            break;
+        }
+        reportProgress();
+        auto start = std::chrono::steady_clock::now();
         MArea& currentArea = placedPieces[i];
         
         for (int j = 0; j < i; ++j) {
@@ -407,10 +621,11 @@ bool Bin::moveAndReplace(size_t indexLimit) {
                 // Try without rotation
                 MArea candidate = currentArea;
                 candidate.placeInPosition(RectangleUtils::getX(contBB), RectangleUtils::getY(contBB));
+                snap(candidate);
 
                 if (auto swept = sweep(container, candidate, i)) {
                     freeRectangles.push_back(currentArea.getBoundingBox2D());
-                    placedPieces[i] = *swept;
+                    replacePlacedPiece(i, *swept);
                     compressPiece(i, MVector(-1.0, -1.0));
                     computeFreeRectangles(swept->getBoundingBox2D());
                     eliminateNonMaximal();
@@ -422,9 +637,10 @@ bool Bin::moveAndReplace(size_t indexLimit) {
                 candidate = currentArea;
                 candidate.rotate(90);
                 candidate.placeInPosition(RectangleUtils::getX(contBB), RectangleUtils::getY(contBB));
+                snap(candidate);
                 if (auto swept = sweep(container, candidate, i)) {
                     freeRectangles.push_back(currentArea.getBoundingBox2D());
-                    placedPieces[i] = *swept;
+                    replacePlacedPiece(i, *swept);
                     compressPiece(i, MVector(-1.0, -1.0));
                     computeFreeRectangles(swept->getBoundingBox2D());
                     eliminateNonMaximal();
@@ -433,41 +649,80 @@ bool Bin::moveAndReplace(size_t indexLimit) {
                 }
             }
         }
-        next_piece:;
+        next_piece:
+        recordPlacementLatency(start, placedPieces[i]);
     }
     return movement;
 }
 
+void Bin::snap(MArea& piece) const {
+    if (isFixedPoint()) {
+        piece.snapToGrid(config.fixedPointScale);
+    }
+}
+
+bool Bin::intersects(const MArea& a, const MArea& b) const {
+    return isFixedPoint() ? FixedPoint::intersects(a, b, config.fixedPointScale) : a.intersection(b);
+}
+
+bool Bin::isPositive(double length) const {
+    return isFixedPoint() ? FixedPoint::toFixed(length, config.fixedPointScale) > 0 : length > 1e-9;
+}
+
+bool Bin::fitsWithin(double extent, double limit) const {
+    return isFixedPoint() ? FixedPoint::toFixed(extent, config.fixedPointScale) <= FixedPoint::toFixed(limit, config.fixedPointScale)
+                          : extent <= limit + 1e-9;
+}
+
+void Bin::replacePlacedPiece(size_t pieceIndex, const MArea& piece) {
+    placedPieces[pieceIndex] = piece;
+    trackPlacedPieces();
+    spatialIndex.update(pieceIndex, piece.getBoundingBox2D());
+}
+
 std::optional<MArea> Bin::sweep(const MArea& container, MArea inside, size_t ignoredPieceIndex) {
-    if (!inside.intersection(container) && !isCollision(inside, ignoredPieceIndex)) {
+    // The working copy of the piece is the scratch storage of the sweep.
+    Memory::ScopedCharge insideCharge(*memoryTracker, Stats::MemoryCategory::Temporary, inside.getMemoryUsage());
+    counters().narrowPhaseTests++;
+    if (!intersects(inside, container) && !isCollision(inside, ignoredPieceIndex)) {
         return inside;
     }
 
     Rectangle2D containerBB = container.getBoundingBox2D();
     Rectangle2D insideBB_orig = inside.getBoundingBox2D();
 
-    double dx_factor = Constants::DX_SWEEP_FACTOR;
-    double dy_factor = Constants::DY_SWEEP_FACTOR;
+    double dx_factor = config.dxSweepFactor;
+    double dy_factor = config.dySweepFactor;
 
-    if (inside.getVertexCount() > 100) {
-        dx_factor = 2;
-        dy_factor = 1;
+    if (inside.getVertexCount() > config.complexPieceVertexThreshold) {
+        dx_factor = config.complexDxSweepFactor;
+        dy_factor = config.complexDySweepFactor;
     }
 
     double dx = RectangleUtils::getWidth(insideBB_orig) / dx_factor;
     double dy = RectangleUtils::getHeight(insideBB_orig) / dy_factor;
-    if (dx < 1e-9) dx = 1.0;
-    if (dy < 1e-9) dy = 1.0;
+    if (!isPositive(dx)) dx = 1.0;
+    if (!isPositive(dy)) dy = 1.0;
 
     double startX = RectangleUtils::getX(containerBB);
     double startY = RectangleUtils::getY(containerBB);
     double endX = RectangleUtils::getMaxX(containerBB);
     double endY = RectangleUtils::getMaxY(containerBB);
 
-    for (double y = startY; y + RectangleUtils::getHeight(insideBB_orig) <= endY + 1e-9; y += dy) {
-        for (double x = startX; x + RectangleUtils::getWidth(insideBB_orig) <= endX + 1e-9; x += dx) {
+    for (double y = startY; fitsWithin(y + RectangleUtils::getHeight(insideBB_orig), endY); y += dy) {
+        if (isCancelled()) {
+            return std::nullopt;
+        }
+        for (double x = startX; fitsWithin(x + RectangleUtils::getWidth(insideBB_orig), endX); x += dx) {
             inside.placeInPosition(x, y);
-            if (inside.isInside(this->dimension) && !inside.intersection(container) && !isCollision(inside, ignoredPieceIndex)) {
+            snap(inside);
+            Stats::Counters& c = counters();
+            c.sweepCells++;
+            if (!inside.isInside(this->dimension)) {
+                continue;
+            }
+            c.narrowPhaseTests++;
+            if (!intersects(inside, container) && !isCollision(inside, ignoredPieceIndex)) {
                 return inside;
             }
         }
@@ -2,13 +2,21 @@
 
 #include "primitives/MArea.h"
 #include "primitives/Rectangle.h"
+#include "core/Stats.h"
+#include "core/Memory.h"
+#include "core/Progress.h"
+#include "core/PackingConfig.h"
+#include "core/SpatialIndex.h"
+#include <chrono>
+#include <memory>
 #include <vector>
 #include <optional>
 #include <mutex>
-#include <boost/geometry/index/rtree.hpp>
+#include <boost/container/small_vector.hpp>
 
-// Forward declaration for the test fixture to be declared as a friend.
+// Forward declarations for the test and benchmark fixtures to be declared as friends.
 class BinTest;
+class BinBenchmarkAccess;
 
 
 /**
@@ -18,19 +26,44 @@ class BinTest;
 class Bin {
 public:
     friend class BinTest; // Grant access to the test fixture
+    friend class BinBenchmarkAccess; // Grant access to the benchmark suite
     /**
      * @brief Initializes this bin with the specified dimensions.
      * @param dimension The rectangle defining the bin's boundaries.
+     * @param config Step factors used by dive and sweep.
      */
-    Bin(const Rectangle2D& dimension);
+    Bin(const Rectangle2D& dimension, const PackingConfig& config = PackingConfig());
+
+    /**
+     * @brief Restores a bin from its layout, e.g. when deserializing.
+     * The spatial index is built from the pieces; the statistics start empty.
+     * @param dimension The rectangle defining the bin's boundaries.
+     * @param config Step factors used by dive and sweep.
+     * @param placedPieces The pieces, already in their placed position.
+     * @param freeRectangles The maximal free rectangles left by the pieces.
+     */
+    Bin(const Rectangle2D& dimension, const PackingConfig& config, std::vector<MArea> placedPieces,
+        const std::vector<Rectangle2D>& freeRectangles);
     Bin(const Bin& other);
     Bin& operator=(const Bin& other);
 
+    /**
+     * @brief Takes over the pieces, the free rectangles and the spatial index without copying them.
+     * The moved-from bin may only be destroyed or assigned to.
+     */
+    Bin(Bin&& other) noexcept;
+    Bin& operator=(Bin&& other) noexcept;
+
     /**
      * @brief Get the placed pieces.
      */
     const std::vector<MArea>& getPlacedPieces() const;
 
+    /**
+     * @brief Get the maximal free rectangles, as used by boundingBoxPacking.
+     */
+    std::vector<Rectangle2D> getFreeRectangles() const;
+
     /**
      * @brief Get the number of pieces placed.
      */
@@ -51,6 +84,24 @@ public:
      */
     double getEmptyArea() const;
 
+    /**
+     * @brief Get the step factors used by this bin.
+     */
+    const PackingConfig& getConfig() const;
+
+    /**
+     * @brief Get the hot-path counters and heap usage collected so far, per stage.
+     */
+    const Stats::BinStats& getStats() const;
+
+    /**
+     * @brief Attaches progress reporting and cancellation to the stages of this bin.
+     * Neither is owned by the bin nor copied with it; pass nullptr to detach.
+     * When the token is cancelled, the running stage stops at its next check and returns with
+     * a valid layout; the pieces it did not get to are returned as not placed.
+     */
+    void setProgress(Progress::Reporter* reporter, const Progress::CancellationToken* cancellation);
+
     /**
      * @brief Places pieces inside the bin using the maximal rectangles strategy.
      * This is the C++ version of the `boundingBoxPacking` method from the original Java code.
@@ -59,6 +110,14 @@ public:
      */
     std::vector<MArea> boundingBoxPacking(std::vector<MArea>& piecesToPlace, bool useParallel);
 
+    /**
+     * @brief boundingBoxPacking over a subset of a pool of pieces, given by index; only the pieces placed are copied.
+     * @param pieces The pool the indices refer to.
+     * @param indices Indices in pieces of the pieces to place. They will be sorted by decreasing area.
+     * @return The indices of the pieces that could not be placed, in the order they were tried.
+     */
+    std::vector<size_t> boundingBoxPacking(const std::vector<MArea>& pieces, std::vector<size_t>& indices, bool useParallel);
+
     /**
      * @brief Compress all placed pieces in this bin towards the lower-left corner.
      */
@@ -72,6 +131,14 @@ public:
      */
     std::vector<MArea> dropPieces(const std::vector<MArea>& piecesToDrop, bool useParallel);
 
+    /**
+     * @brief dropPieces over a subset of a pool of pieces, given by index.
+     * @param pieces The pool the indices refer to.
+     * @param indices Indices in pieces of the pieces to drop, in the order they are tried.
+     * @return The indices of the pieces that could not be placed.
+     */
+    std::vector<size_t> dropPieces(const std::vector<MArea>& pieces, const std::vector<size_t>& indices, bool useParallel);
+
     /**
      * @brief Tries to place already placed pieces inside other placed pieces.
      * This is the C++ version of the `moveAndReplace` method from the original Java code.
@@ -98,26 +165,81 @@ public:
     Placement findWhereToPlace(const MArea& piece, bool useParallel);
 
 private:
-    // Type definitions for the R-tree.
-    // It will store pairs of <Rectangle2D, size_t>, where size_t is the index
-    // of the piece in the placedPieces vector.
-    using RTreeValue = std::pair<Rectangle2D, size_t>;
-    using RTree = boost::geometry::index::rtree<RTreeValue, boost::geometry::index::rstar<16>>;
+    // Containers whose allocations are reported to the bin's memory tracker.
+    template <typename T>
+    using TrackedVector = std::vector<T, Memory::TrackingAllocator<T>>;
+
+    // Broad-phase candidates of isCollision as (overlap area, piece index). Kept on the stack for the
+    // usual handful of candidates; only a larger set reaches the heap, through the tracked allocator.
+    using Candidate = std::pair<double, size_t>;
+    using CandidateBuffer = boost::container::small_vector<Candidate, 16, Memory::TrackingAllocator<Candidate>>;
 
     Rectangle2D dimension;
-    std::vector<MArea> placedPieces;
-    std::vector<Rectangle2D> freeRectangles;
-    RTree placedPiecesRTree; // The new spatial index
+    PackingConfig config;
+
+    // Declared before the containers: the tracker must outlive every allocation it accounts for.
+    // It lives on the heap so that the allocators of the containers still point to it after a move.
+    Stats::BinStats stats;
+    Stats::Stage currentStage = Stats::Stage::BoundingBoxPacking; // Stage the counters are attributed to.
+    std::unique_ptr<Memory::Tracker> memoryTracker;
+
+    std::vector<MArea> placedPieces; // Part of the public API, so accounted with trackPlacedPieces() instead of an allocator.
+    TrackedVector<Rectangle2D> freeRectangles;
+    SpatialIndex spatialIndex; // Boxes of the placed pieces, by index in placedPieces.
+
+    Progress::Reporter* progress = nullptr;
+    const Progress::CancellationToken* cancellation = nullptr;
+
+    Stats::Counters& counters() { return stats.stage(currentStage); }
+
+    bool isCancelled() const { return cancellation && cancellation->isCancelled(); }
+
+    /**
+     * @brief Sends a progress report if one is due. Called at coarse points of the stage loops.
+     */
+    void reportProgress();
+
+    template <typename T>
+    Memory::TrackingAllocator<T> trackedAllocator(Stats::MemoryCategory category) {
+        return Memory::TrackingAllocator<T>(memoryTracker.get(), category);
+    }
+
+    /**
+     * @brief Exchanges the whole state of two bins, trackers and allocators included.
+     */
+    void swap(Bin& other) noexcept;
+
+    /**
+     * @brief Attributes the following work and allocations to a stage.
+     */
+    void enterStage(Stats::Stage stage);
+
+    /**
+     * @brief Records the time spent on a piece since start in the latency histogram of the
+     * current stage, under the vertex bucket of the piece.
+     */
+    void recordPlacementLatency(std::chrono::steady_clock::time_point start, const MArea& piece);
+
+    /**
+     * @brief Reports the bytes held by placedPieces, including the vertices of every piece.
+     * Must be called after placedPieces changes size or a piece is replaced.
+     */
+    void trackPlacedPieces();
 
     /**
      * @brief Checks if a given piece collides with any of the already placed pieces.
-     * This is the core of the R-tree optimization.
+     * This is the core of the spatial index optimization.
      * @param piece The piece to check.
      * @param ignoredPieceIndex An optional index of a piece to ignore during the check (e.g., the piece itself if it's being moved).
      * @return True if there is a collision, false otherwise.
      */
     bool isCollision(const MArea& piece, std::optional<size_t> ignoredPieceIndex = std::nullopt);
 
+    /**
+     * @brief The collision test proper, through the spatial index; isCollision adds the validation hook.
+     */
+    bool isCollisionIndexed(const MArea& piece, std::optional<size_t> ignoredPieceIndex);
+
     /**
      * @brief Divides the rectangular space where a piece was just placed.
      * @param usedFreeArea Rectangular area that contains the newly placed piece.
@@ -136,6 +258,15 @@ private:
      */
     void eliminateNonMaximal();
 
+    /**
+     * @brief Moves a piece by unit steps along each axis of a direction until neither step is free.
+     * @param piece The piece to move, in place.
+     * @param vector The direction (e.g., (0, -1) to let the piece fall).
+     * @param ignoredPieceIndex The index of the piece if it is placed, so that it does not collide with its own box.
+     * @return The number of steps taken.
+     */
+    int slide(MArea& piece, const MVector& vector, std::optional<size_t> ignoredPieceIndex);
+
     /**
      * @brief Helper to compress a single piece towards a direction, avoiding collisions.
      * @param pieceIndex The index of the piece to move in the placedPieces vector.
@@ -160,6 +291,30 @@ private:
      */
     std::optional<MArea> dive(MArea toDive, bool useParallel);
 
+    /**
+     * @brief Lets a free piece descend and returns it at its final position.
+     */
+    MArea settle(const MArea& piece);
+
+    // Clearance a settled piece keeps above the piece it lands on, as touching counts as a
+    // collision: below the 1e-9 the bin takes for no length, so that the piece rests on the
+    // other. One grid unit in fixed-point mode.
+    static constexpr double DROP_GAP = 1e-10;
+
+    // Fixed-point mode (PackingConfig::fixedPointScale): pieces are rounded to the grid after every
+    // transformation, collisions use the exact predicates of FixedPoint and lengths are compared in
+    // whole grid units. Otherwise these fall back to Boost.Geometry and a 1e-9 tolerance.
+    bool isFixedPoint() const { return config.fixedPointScale > 0; }
+    void snap(MArea& piece) const;
+    bool intersects(const MArea& a, const MArea& b) const;
+    bool isPositive(double length) const;
+    bool fitsWithin(double extent, double limit) const; // extent <= limit
+
+    /**
+     * @brief Replaces a placed piece, keeping its spatial index entry in step with the new geometry.
+     */
+    void replacePlacedPiece(size_t pieceIndex, const MArea& piece);
+
     /**
      * @brief Sweeps a piece along the interior of a container searching for a non-overlapping position.
      * @param container The piece that contains the free space.
@@ -1,21 +1,48 @@
 #include "BinPacking.h"
+#include "utils/Trace.h"
+#include "utils/ThreadPool.h"
+#include <future>
+#include <memory>
 #include <algorithm>
 #include <iostream>
+#include <numeric>
 
 namespace BinPacking {
 
 std::vector<Bin> pack(std::vector<MArea>& pieces, const Rectangle2D& binDimension, bool useParallel) {
+    PackOptions options;
+    options.useParallel = useParallel;
+    return pack(pieces, binDimension, options);
+}
+
+std::vector<Bin> pack(std::vector<MArea>& pieces, const Rectangle2D& binDimension, const PackOptions& options) {
+    TRACE_SCOPE("pack", "pieces", static_cast<int64_t>(pieces.size()));
     std::vector<Bin> bins;
+    const bool useParallel = options.useParallel;
+    auto cancelled = [&options]() {
+        return options.cancellation && options.cancellation->isCancelled();
+    };
+
+    double totalArea = 0.0;
+    for (const auto& piece : pieces) {
+        totalArea += piece.getArea();
+    }
+    Progress::Reporter reporter(options.onProgress, options.progressInterval, pieces.size(), totalArea);
+    Progress::Reporter* progress = options.onProgress ? &reporter : nullptr;
+    size_t piecesPlaced = 0;
+    double areaPlaced = 0.0;
 
     // Sort pieces by area, largest first.
     std::sort(pieces.begin(), pieces.end(), [](const MArea& a, const MArea& b) {
         return a.getArea() > b.getArea();
     });
 
-    std::vector<MArea> toPlace = pieces;
+    // The stages work on indices into pieces; a piece is only copied when it is placed.
+    std::vector<size_t> toPlace(pieces.size());
+    std::iota(toPlace.begin(), toPlace.end(), 0);
     size_t lastLoopUnplacedCount = 0; // For infinite loop detection
 
-    while (!toPlace.empty()) {
+    while (!toPlace.empty() && !cancelled()) {
         // *** INFINITE LOOP GUARD ***
         if (lastLoopUnplacedCount > 0 && toPlace.size() == lastLoopUnplacedCount) {
             std::cerr << "Error: Infinite loop detected. "
@@ -25,16 +52,20 @@ std::vector<Bin> pack(std::vector<MArea>& pieces, const Rectangle2D& binDimensio
         }
         lastLoopUnplacedCount = toPlace.size();
 
-        bins.emplace_back(binDimension);
+        TRACE_SCOPE("bin", "index", static_cast<int64_t>(bins.size()));
+        bins.emplace_back(binDimension, options.config);
         Bin& currentBin = bins.back();
         size_t nPiecesBefore = currentBin.getNPlaced();
+        reporter.beginBin(bins.size(), piecesPlaced, areaPlaced);
+        currentBin.setProgress(progress, options.cancellation);
 
         // Stage 1: Initial packing using bounding boxes.
-        std::vector<MArea> stillNotPlaced = currentBin.boundingBoxPacking(toPlace, useParallel);
+        std::vector<size_t> stillNotPlaced = currentBin.boundingBoxPacking(pieces, toPlace, useParallel);
 
         // Stage 2: Iteratively optimize and repack.
         if (currentBin.getNPlaced() > nPiecesBefore) {
-            while (true) {
+            for (int64_t iteration = 0; ; ++iteration) {
+                TRACE_SCOPE("repackIteration", "iteration", iteration);
                 size_t piecesInBinBeforeRepack = currentBin.getNPlaced();
 
                 // Try to optimize the layout by moving pieces
@@ -42,13 +73,13 @@ std::vector<Bin> pack(std::vector<MArea>& pieces, const Rectangle2D& binDimensio
 
                 // Attempt to pack more pieces into the potentially new free space
                 if (!stillNotPlaced.empty()) {
-                    stillNotPlaced = currentBin.boundingBoxPacking(stillNotPlaced, useParallel);
+                    stillNotPlaced = currentBin.boundingBoxPacking(pieces, stillNotPlaced, useParallel);
                 }
 
                 // The loop is stable and should terminate if no new pieces were added.
                 // The `moveAndReplace` might shuffle pieces internally, but if it doesn't
                 // create space for new pieces, we are not making progress.
-                if (currentBin.getNPlaced() == piecesInBinBeforeRepack) {
+                if (currentBin.getNPlaced() == piecesInBinBeforeRepack || cancelled()) {
                     break;
                 }
             }
@@ -57,22 +88,108 @@ std::vector<Bin> pack(std::vector<MArea>& pieces, const Rectangle2D& binDimensio
         // Stage 3: Final compression and drop pass to fill any remaining gaps.
         currentBin.compress(useParallel);
         if (!stillNotPlaced.empty()) {
-            stillNotPlaced = currentBin.dropPieces(stillNotPlaced, useParallel);
+            stillNotPlaced = currentBin.dropPieces(pieces, stillNotPlaced, useParallel);
         }
         currentBin.compress(useParallel);
+        currentBin.setProgress(nullptr, nullptr);
 
         // If the bin is still empty, it means the largest remaining piece is too big.
         if (currentBin.getNPlaced() == nPiecesBefore) {
-            std::cerr << "Warning: Could not place any of the " << toPlace.size()
-                      << " remaining pieces into a new bin. The largest piece might be too big." << std::endl;
+            if (!cancelled()) {
+                std::cerr << "Warning: Could not place any of the " << toPlace.size()
+                          << " remaining pieces into a new bin. The largest piece might be too big." << std::endl;
+            }
             bins.pop_back(); // Remove the unused bin.
             break;
         }
 
-        toPlace = stillNotPlaced;
+        piecesPlaced += currentBin.getNPlaced();
+        areaPlaced += currentBin.getOccupiedArea();
+        toPlace = std::move(stillNotPlaced);
     }
 
+    if (progress) {
+        reporter.beginBin(bins.size(), piecesPlaced, areaPlaced);
+        reporter.finish(cancelled());
+    }
     return bins;
 }
 
+std::vector<std::vector<Bin>> packMany(std::vector<PackJob>& jobs, size_t threads) {
+    std::unique_ptr<ThreadPool> ownPool;
+    if (threads > 0) {
+        ownPool = std::make_unique<ThreadPool>(std::min(threads, std::max<size_t>(jobs.size(), 1)));
+    }
+    ThreadPool& pool = ownPool ? *ownPool : ThreadPool::shared();
+
+    std::vector<std::future<std::vector<Bin>>> pending;
+    pending.reserve(jobs.size());
+    for (auto& job : jobs) {
+        pending.push_back(pool.submit([&job]() { return pack(job.pieces, job.binDimension, job.options); }));
+    }
+
+    std::vector<std::vector<Bin>> results;
+    results.reserve(jobs.size());
+    for (auto& future : pending) {
+        results.push_back(future.get());
+    }
+    return results;
+}
+
+Stats::PackStats collectStats(const std::vector<Bin>& bins) {
+    Stats::PackStats stats;
+    stats.bins.reserve(bins.size());
+    for (const auto& bin : bins) {
+        stats.bins.push_back(bin.getStats());
+    }
+    return stats;
+}
+
+void appendPlacements(const Bin& bin, int32_t binIndex, std::vector<PlacementRecord>& records) {
+    for (const auto& piece : bin.getPlacedPieces()) {
+        Rectangle2D bbox = piece.getBoundingBox2D();
+        records.push_back({binIndex, piece.getID(), piece.getRotation(),
+                           RectangleUtils::getX(bbox), RectangleUtils::getY(bbox), piece.getArea()});
+    }
+}
+
+std::vector<PlacementRecord> collectPlacements(const std::vector<Bin>& bins) {
+    std::vector<PlacementRecord> records;
+    for (size_t i = 0; i < bins.size(); ++i) {
+        appendPlacements(bins[i], static_cast<int32_t>(i), records);
+    }
+    return records;
+}
+
+void appendGeometry(const Bin& bin, PlacementGeometry& geometry) {
+    auto appendRing = [&geometry](const ShapeView::RingSpan& ring) {
+        size_t n = ring.size();
+        if (n > 1 && bg::equals(ring.front(), ring.back())) {
+            n--; // Drop the closing vertex.
+        }
+        for (size_t i = 0; i < n; ++i) {
+            geometry.xy.push_back(ring[i].x());
+            geometry.xy.push_back(ring[i].y());
+        }
+        geometry.ringOffsets.push_back(static_cast<int64_t>(geometry.xy.size() / 2));
+    };
+    for (const auto& piece : bin.getPlacedPieces()) {
+        for (const auto& polygon : piece.view()) {
+            appendRing(polygon.outer);
+            for (const auto& hole : polygon.inners) {
+                appendRing(hole);
+            }
+        }
+        geometry.pieceRingOffsets.push_back(static_cast<int64_t>(geometry.ringOffsets.size() - 1));
+    }
+}
+
+PlacementGeometry collectGeometry(const std::vector<Bin>& bins) {
+    PlacementGeometry geometry;
+    for (const auto& bin : bins) {
+        appendGeometry(bin, geometry);
+    }
+    return geometry;
+}
+
 } // namespace BinPacking
\ No newline at end of file
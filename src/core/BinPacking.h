@@ -3,10 +3,32 @@
 #include "Bin.h"
 #include "primitives/MArea.h"
 #include "primitives/Rectangle.h"
+#include "core/Stats.h"
+#include "core/Progress.h"
+#include "core/PackingConfig.h"
+#include <chrono>
+#include <cstdint>
 #include <vector>
 
 namespace BinPacking {
 
+/**
+ * @brief Options of a pack run.
+ */
+struct PackOptions {
+    bool useParallel = false;
+
+    // Step factors given to every bin.
+    PackingConfig config;
+
+    // Called on the thread running pack, at most once per progressInterval, plus a final report.
+    Progress::Callback onProgress;
+    std::chrono::milliseconds progressInterval{200};
+
+    // Checked inside the long loops of every stage. Not owned; must outlive the call.
+    const Progress::CancellationToken* cancellation = nullptr;
+};
+
 /**
  * @brief Main strategy for the 2D bin packing problem.
  * Equivalent to org.packing.core.BinPacking.BinPackingStrategy.
@@ -17,5 +39,82 @@ namespace BinPacking {
  */
 std::vector<Bin> pack(std::vector<MArea>& pieces, const Rectangle2D& binDimension, bool useParallel);
 
+/**
+ * @brief Same as above, with progress reporting and cancellation.
+ * If the run is cancelled, the bins packed so far are returned, the last one possibly partially
+ * filled; options.cancellation->isCancelled() tells the caller the result is incomplete.
+ */
+std::vector<Bin> pack(std::vector<MArea>& pieces, const Rectangle2D& binDimension, const PackOptions& options);
+
+/**
+ * @brief One independent problem for packMany.
+ */
+struct PackJob {
+    std::vector<MArea> pieces;
+    Rectangle2D binDimension;
+    PackOptions options;
+};
+
+/**
+ * @brief Packs independent problems side by side, one pack() run per worker thread.
+ *
+ * @param jobs The problems; their pieces are modified as by pack (sorted).
+ * @param threads Number of workers; 0 schedules the jobs on ThreadPool::shared(), in which
+ *        case packMany must not itself be called from a task of the shared pool.
+ * @return The bins of each job, in the order of jobs.
+ */
+std::vector<std::vector<Bin>> packMany(std::vector<PackJob>& jobs, size_t threads = 0);
+
+/**
+ * @brief Gathers the hot-path counters of every bin of a pack run.
+ *
+ * @param bins The bins returned by pack.
+ * @return The per-bin, per-stage statistics.
+ */
+Stats::PackStats collectStats(const std::vector<Bin>& bins);
+
+/**
+ * @brief One placed piece of a pack result, in a flat layout suitable for export
+ * (e.g. as a NumPy structured array).
+ */
+struct PlacementRecord {
+    int32_t binIndex; // 0-based index of the bin holding the piece.
+    int32_t pieceId;
+    double rotation;  // Degrees, as returned by MArea::getRotation().
+    double x;         // Minimum corner of the bounding box of the placed piece.
+    double y;
+    double area;
+};
+
+/**
+ * @brief Placed geometry of a pack result, in the order of collectPlacements.
+ * Rings are stored open (without the closing vertex), outer ring first, then the holes.
+ */
+struct PlacementGeometry {
+    std::vector<double> xy;                 // Interleaved x, y of every vertex.
+    std::vector<int64_t> ringOffsets{0};    // Ring r is vertices [ringOffsets[r], ringOffsets[r + 1]).
+    std::vector<int64_t> pieceRingOffsets{0}; // Piece p is rings [pieceRingOffsets[p], pieceRingOffsets[p + 1]).
+};
+
+/**
+ * @brief Appends a record for every piece of a bin.
+ */
+void appendPlacements(const Bin& bin, int32_t binIndex, std::vector<PlacementRecord>& records);
+
+/**
+ * @brief Records of every placed piece, bin by bin, in placement order.
+ */
+std::vector<PlacementRecord> collectPlacements(const std::vector<Bin>& bins);
+
+/**
+ * @brief Appends the transformed rings of every piece of a bin.
+ */
+void appendGeometry(const Bin& bin, PlacementGeometry& geometry);
+
+/**
+ * @brief Transformed rings of every placed piece, in the order of collectPlacements.
+ */
+PlacementGeometry collectGeometry(const std::vector<Bin>& bins);
+
 } // namespace BinPacking
 
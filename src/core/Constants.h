@@ -11,18 +11,21 @@ namespace Constants {
 /**
  * @brief Division factor when trying different positions to drop the piece along
  * the X axes. Increasing this factor will produce smaller horizontal steps.
+ * Default of PackingConfig::diveHorizontalDisplacementFactor.
  */
 constexpr int DIVE_HORIZONTAL_DISPLACEMENT_FACTOR = 3;
 
 /**
  * @brief Division factor for the displacement of pieces.
  * Increasing this factor will produce smaller horizontal steps.
+ * Default of PackingConfig::dxSweepFactor.
  */
 constexpr int DX_SWEEP_FACTOR = 10;
 
 /**
  * @brief Division factor for the displacement of pieces.
  * Increasing this factor will produce smaller vertical steps.
+ * Default of PackingConfig::dySweepFactor.
  */
 constexpr int DY_SWEEP_FACTOR = 2;
 
@@ -0,0 +1,161 @@
+#pragma once
+
+#include "core/Stats.h"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+/**
+ * @brief Heap accounting for a Bin, attributed by category and by stage.
+ * Containers owned by a bin allocate through a TrackingAllocator bound to the bin's Tracker;
+ * storage that cannot take an allocator (the vertices inside MArea) is reported with set().
+ */
+namespace Memory {
+
+/**
+ * @brief Keeps the bytes currently held by a bin and publishes them, with the peaks of the
+ * running stage, into the bin's BinStats. Not thread-safe: a bin is only used by one thread at a time.
+ */
+class Tracker {
+public:
+    /**
+     * @param stats Statistics of the bin, updated on every change.
+     * @param stage Stage of the bin the changes are attributed to.
+     */
+    Tracker(Stats::BinStats& stats, const Stats::Stage& stage) : stats(&stats), stage(&stage) {}
+
+    // A tracker belongs to one bin; a copied bin gets a tracker of its own. A moved bin keeps
+    // its tracker, which stays at the same address, and re-attaches it to its new members.
+    Tracker(const Tracker&) = delete;
+    Tracker& operator=(const Tracker&) = delete;
+
+    /**
+     * @brief Points the tracker at the statistics and stage of the bin that now owns it.
+     */
+    void attach(Stats::BinStats& stats, const Stats::Stage& stage) {
+        this->stats = &stats;
+        this->stage = &stage;
+    }
+
+    void allocate(Stats::MemoryCategory category, size_t bytes) {
+        current[static_cast<size_t>(category)] += bytes;
+        publish();
+    }
+
+    void deallocate(Stats::MemoryCategory category, size_t bytes) {
+        current[static_cast<size_t>(category)] -= bytes;
+        publish();
+    }
+
+    /**
+     * @brief Replaces the bytes of a category, for storage that is measured rather than allocated here.
+     */
+    void set(Stats::MemoryCategory category, size_t bytes) {
+        current[static_cast<size_t>(category)] = bytes;
+        publish();
+    }
+
+    /**
+     * @brief Publishes the bytes held now into the stats of the current stage.
+     * Called when a stage starts, so that its peak includes what earlier stages left behind.
+     */
+    void publish() {
+        Stats::MemoryUsage& usage = stats->stageMemory(*stage);
+        uint64_t total = 0;
+        for (size_t c = 0; c < Stats::MEMORY_CATEGORY_COUNT; ++c) {
+            usage.peakBytes[c] = std::max(usage.peakBytes[c], current[c]);
+            total += current[c];
+        }
+        usage.peakTotalBytes = std::max(usage.peakTotalBytes, total);
+        usage.currentBytes = current;
+        stats->currentBytes = current;
+    }
+
+private:
+    Stats::BinStats* stats;
+    const Stats::Stage* stage;
+    std::array<uint64_t, Stats::MEMORY_CATEGORY_COUNT> current{};
+};
+
+/**
+ * @brief Standard allocator that reports every allocation to a Tracker under a fixed category.
+ * It does not propagate on assignment, so a container keeps reporting to the tracker it was
+ * constructed with. It does propagate on swap, which is how a bin hands its containers over
+ * together with its tracker. A default-constructed allocator reports nowhere.
+ */
+template <typename T>
+class TrackingAllocator {
+public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::false_type;
+    using propagate_on_container_move_assignment = std::false_type;
+    using propagate_on_container_swap = std::true_type;
+
+    template <typename U>
+    struct rebind {
+        using other = TrackingAllocator<U>;
+    };
+
+    TrackingAllocator() noexcept = default;
+    TrackingAllocator(Tracker* tracker, Stats::MemoryCategory category) noexcept : tracker(tracker), category(category) {}
+
+    template <typename U>
+    TrackingAllocator(const TrackingAllocator<U>& other) noexcept : tracker(other.tracker), category(other.category) {}
+
+    T* allocate(size_t n) {
+        T* p = std::allocator<T>().allocate(n);
+        if (tracker) {
+            tracker->allocate(category, n * sizeof(T));
+        }
+        return p;
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        if (tracker) {
+            tracker->deallocate(category, n * sizeof(T));
+        }
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    template <typename U>
+    bool operator==(const TrackingAllocator<U>& other) const noexcept {
+        return tracker == other.tracker && category == other.category;
+    }
+
+    template <typename U>
+    bool operator!=(const TrackingAllocator<U>& other) const noexcept {
+        return !(*this == other);
+    }
+
+private:
+    template <typename U>
+    friend class TrackingAllocator;
+
+    Tracker* tracker = nullptr;
+    Stats::MemoryCategory category = Stats::MemoryCategory::Temporary;
+};
+
+/**
+ * @brief Charges a number of bytes to a category for the lifetime of the object.
+ * Used for scratch storage that is not allocated through a TrackingAllocator, such as a copy of a piece.
+ */
+class ScopedCharge {
+public:
+    ScopedCharge(Tracker& tracker, Stats::MemoryCategory category, size_t bytes)
+        : tracker(tracker), category(category), bytes(bytes) {
+        tracker.allocate(category, bytes);
+    }
+    ~ScopedCharge() { tracker.deallocate(category, bytes); }
+
+    ScopedCharge(const ScopedCharge&) = delete;
+    ScopedCharge& operator=(const ScopedCharge&) = delete;
+
+private:
+    Tracker& tracker;
+    Stats::MemoryCategory category;
+    size_t bytes;
+};
+
+} // namespace Memory
@@ -0,0 +1,153 @@
+#include "PackingConfig.h"
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace {
+    std::string trim(const std::string& s) {
+        const char* whitespace = " \t\r\n";
+        size_t first = s.find_first_not_of(whitespace);
+        if (first == std::string::npos) return "";
+        size_t last = s.find_last_not_of(whitespace);
+        return s.substr(first, last - first + 1);
+    }
+
+    bool parsePositive(const std::string& text, double& value) {
+        try {
+            size_t used = 0;
+            double parsed = std::stod(text, &used);
+            if (used != text.size() || !(parsed > 0)) return false;
+            value = parsed;
+            return true;
+        } catch (const std::exception&) {
+            return false;
+        }
+    }
+}
+
+namespace {
+    constexpr BroadPhase BROAD_PHASES[] = {BroadPhase::Auto, BroadPhase::Scan, BroadPhase::Grid, BroadPhase::Hash,
+                                           BroadPhase::RTreeLinear, BroadPhase::RTreeQuadratic, BroadPhase::RTreeRStar};
+}
+
+const char* broadPhaseName(BroadPhase broadPhase) {
+    switch (broadPhase) {
+        case BroadPhase::Auto: return "auto";
+        case BroadPhase::Scan: return "scan";
+        case BroadPhase::Grid: return "grid";
+        case BroadPhase::Hash: return "hash";
+        case BroadPhase::RTreeLinear: return "rtree-linear";
+        case BroadPhase::RTreeQuadratic: return "rtree-quadratic";
+        case BroadPhase::RTreeRStar: return "rtree-rstar";
+    }
+    return "unknown";
+}
+
+std::optional<BroadPhase> parseBroadPhase(const std::string& name) {
+    for (BroadPhase broadPhase : BROAD_PHASES) {
+        if (name == broadPhaseName(broadPhase)) {
+            return broadPhase;
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<PackingConfig> PackingConfig::load(const std::string& fileName) {
+    std::ifstream file(fileName);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open config file " << fileName << std::endl;
+        return std::nullopt;
+    }
+
+    PackingConfig config;
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        ++lineNumber;
+        line = trim(line.substr(0, line.find('#')));
+        if (line.empty()) continue;
+
+        auto pos = line.find('=');
+        std::string key = trim(line.substr(0, pos));
+        std::string value = pos == std::string::npos ? "" : trim(line.substr(pos + 1));
+        if (key == "broad_phase") {
+            auto broadPhase = parseBroadPhase(value);
+            if (!broadPhase) {
+                std::cerr << "Error: Invalid value for '" << key << "' in " << fileName << ":" << lineNumber
+                          << " (expected auto, scan, grid, hash, rtree-linear, rtree-quadratic or rtree-rstar)." << std::endl;
+                return std::nullopt;
+            }
+            config.broadPhase = *broadPhase;
+            continue;
+        }
+        double number = 0;
+        if (!parsePositive(value, number)) {
+            std::cerr << "Error: Invalid value for '" << key << "' in " << fileName << ":" << lineNumber
+                      << " (expected a positive number)." << std::endl;
+            return std::nullopt;
+        }
+
+        if (key == "dive_horizontal_displacement_factor") {
+            config.diveHorizontalDisplacementFactor = number;
+        } else if (key == "dx_sweep_factor") {
+            config.dxSweepFactor = number;
+        } else if (key == "dy_sweep_factor") {
+            config.dySweepFactor = number;
+        } else if (key == "complex_piece_vertex_threshold") {
+            config.complexPieceVertexThreshold = static_cast<size_t>(number);
+        } else if (key == "complex_dx_sweep_factor") {
+            config.complexDxSweepFactor = number;
+        } else if (key == "complex_dy_sweep_factor") {
+            config.complexDySweepFactor = number;
+        } else if (key == "fixed_point_scale") {
+            config.fixedPointScale = number;
+        } else {
+            std::cerr << "Error: Unknown key '" << key << "' in " << fileName << ":" << lineNumber << std::endl;
+            return std::nullopt;
+        }
+    }
+    return config;
+}
+
+bool PackingConfig::save(const std::string& fileName, const std::string& comment) const {
+    std::ofstream out(fileName);
+    if (!out.is_open()) {
+        std::cerr << "Error: Could not create config file " << fileName << std::endl;
+        return false;
+    }
+    if (!comment.empty()) {
+        std::istringstream lines(comment);
+        std::string line;
+        while (std::getline(lines, line)) {
+            out << "# " << line << "\n";
+        }
+    }
+    out << "dive_horizontal_displacement_factor = " << diveHorizontalDisplacementFactor << "\n";
+    out << "dx_sweep_factor = " << dxSweepFactor << "\n";
+    out << "dy_sweep_factor = " << dySweepFactor << "\n";
+    out << "complex_piece_vertex_threshold = " << complexPieceVertexThreshold << "\n";
+    out << "complex_dx_sweep_factor = " << complexDxSweepFactor << "\n";
+    out << "complex_dy_sweep_factor = " << complexDySweepFactor << "\n";
+    if (fixedPointScale > 0) {
+        out << "fixed_point_scale = " << fixedPointScale << "\n";
+    }
+    if (broadPhase != BroadPhase::Auto) {
+        out << "broad_phase = " << broadPhaseName(broadPhase) << "\n";
+    }
+    return static_cast<bool>(out);
+}
+
+std::string PackingConfig::toString() const {
+    std::ostringstream out;
+    out << "dive=" << diveHorizontalDisplacementFactor
+        << " dx=" << dxSweepFactor
+        << " dy=" << dySweepFactor
+        << " complex(>" << complexPieceVertexThreshold << ")=" << complexDxSweepFactor << "/" << complexDySweepFactor;
+    if (fixedPointScale > 0) {
+        out << " fixed=" << fixedPointScale;
+    }
+    if (broadPhase != BroadPhase::Auto) {
+        out << " broad=" << broadPhaseName(broadPhase);
+    }
+    return out.str();
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "core/Constants.h"
+#include <cstddef>
+#include <optional>
+#include <string>
+
+/**
+ * @brief Data structure of the broad phase of the collision test (see SpatialIndex).
+ * All of them report the same candidates; they only differ in speed and memory.
+ */
+enum class BroadPhase {
+    Auto,           // Chosen from the number and the sizes of the placed pieces.
+    Scan,           // Linear scan over an array of boxes.
+    Grid,           // Uniform grid over the bin.
+    Hash,           // Spatial hash: a grid of unbounded extent, hashed into as many buckets as pieces.
+    RTreeLinear,    // Boost R-tree with linear splits.
+    RTreeQuadratic, // Boost R-tree with quadratic splits.
+    RTreeRStar      // Boost R*-tree.
+};
+
+/**
+ * @brief The name of a broad phase in configuration files and on the command line, e.g. "rtree-rstar".
+ */
+const char* broadPhaseName(BroadPhase broadPhase);
+
+/**
+ * @brief The broad phase with the given name, or std::nullopt.
+ */
+std::optional<BroadPhase> parseBroadPhase(const std::string& name);
+
+/**
+ * @brief Runtime step factors of the packing stages, the main speed/quality dial of the algorithm.
+ * The defaults are the values of Constants. Larger factors give smaller steps: better
+ * packings at a higher cost.
+ */
+struct PackingConfig {
+    // Division factor of the piece width for the horizontal start positions tried by dive.
+    double diveHorizontalDisplacementFactor = Constants::DIVE_HORIZONTAL_DISPLACEMENT_FACTOR;
+
+    // Division factors of the piece size for the grid steps of sweep.
+    double dxSweepFactor = Constants::DX_SWEEP_FACTOR;
+    double dySweepFactor = Constants::DY_SWEEP_FACTOR;
+
+    // Pieces with more vertices than this are swept with the coarser factors below,
+    // since each of their intersection tests is expensive.
+    size_t complexPieceVertexThreshold = 100;
+    double complexDxSweepFactor = 2;
+    double complexDySweepFactor = 1;
+
+    // Grid units per file unit of the fixed-point mode, 0 for plain floating point. When set, the
+    // bins round every placed piece to a multiple of 1 / fixedPointScale and decide collisions and
+    // length comparisons exactly on that grid (see FixedPoint), without tolerances.
+    double fixedPointScale = 0;
+
+    // Broad phase of the collision tests of the bins. It has no effect on the packing.
+    BroadPhase broadPhase = BroadPhase::Auto;
+
+    /**
+     * @brief Loads a configuration from a 'key = value' file ('#' starts a comment).
+     * Keys that are not present keep their default values.
+     * @return std::nullopt if the file cannot be opened, or has an unknown key or an invalid value.
+     */
+    static std::optional<PackingConfig> load(const std::string& fileName);
+
+    /**
+     * @brief Writes the configuration in the format read by load().
+     * @param comment Optional text written as a comment header.
+     * @return True if the file was written.
+     */
+    bool save(const std::string& fileName, const std::string& comment = "") const;
+
+    /**
+     * @brief One-line summary, e.g. "dive=3 dx=10 dy=2 complex(>100)=2/1".
+     * The fixed-point scale and the broad phase are only listed when not at their defaults.
+     */
+    std::string toString() const;
+};
@@ -0,0 +1,55 @@
+#include "Progress.h"
+
+namespace Progress {
+
+Reporter::Reporter(Callback callback, std::chrono::milliseconds interval, size_t piecesTotal, double areaTotal)
+    : callback(std::move(callback)),
+      interval(interval),
+      piecesTotal(piecesTotal),
+      areaTotal(areaTotal),
+      start(std::chrono::steady_clock::now()),
+      nextReport(start + interval) {
+}
+
+void Reporter::beginBin(size_t binsOpened, size_t piecesPlacedBefore, double areaPlacedBefore) {
+    this->binsOpened = binsOpened;
+    piecesBefore = piecesPlacedBefore;
+    areaBefore = areaPlacedBefore;
+}
+
+Report Reporter::makeReport(size_t piecesInBin, double areaInBin, Stats::Stage stage) {
+    auto now = std::chrono::steady_clock::now();
+    nextReport = now + interval;
+
+    Report r;
+    r.piecesPlaced = piecesBefore + piecesInBin;
+    r.piecesTotal = piecesTotal;
+    r.binsOpened = binsOpened;
+    r.stage = stage;
+    r.elapsedSeconds = std::chrono::duration<double>(now - start).count();
+
+    // Pieces are packed largest first, so the placed area tracks the work done better than the piece count.
+    double fraction = areaTotal > 0.0 ? (areaBefore + areaInBin) / areaTotal : 0.0;
+    if (fraction > 0.0 && fraction < 1.0) {
+        r.etaSeconds = r.elapsedSeconds * (1.0 - fraction) / fraction;
+    }
+    return r;
+}
+
+void Reporter::report(size_t piecesInBin, double areaInBin, Stats::Stage stage) {
+    if (callback) {
+        callback(makeReport(piecesInBin, areaInBin, stage));
+    }
+}
+
+void Reporter::finish(bool cancelled) {
+    Report r = makeReport(0, 0.0, Stats::Stage::Compress);
+    r.finished = true;
+    r.cancelled = cancelled;
+    r.etaSeconds = cancelled ? -1.0 : 0.0;
+    if (callback) {
+        callback(r);
+    }
+}
+
+} // namespace Progress
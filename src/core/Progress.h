@@ -0,0 +1,95 @@
+#pragma once
+
+#include "core/Stats.h"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+
+/**
+ * @brief Progress reporting and cooperative cancellation of a pack run.
+ */
+namespace Progress {
+
+/**
+ * @brief Cancellation flag shared between a pack run and the code that wants to stop it.
+ * cancel() may be called from any thread; the run stops at the next check in its long loops
+ * and returns the bins packed so far.
+ */
+class CancellationToken {
+public:
+    void cancel() { cancelled.store(true, std::memory_order_relaxed); }
+    void reset() { cancelled.store(false, std::memory_order_relaxed); }
+    bool isCancelled() const { return cancelled.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<bool> cancelled{false};
+};
+
+/**
+ * @brief Snapshot of a pack run, passed to the progress callback.
+ */
+struct Report {
+    size_t piecesPlaced = 0;   // Pieces placed in all bins so far.
+    size_t piecesTotal = 0;    // Pieces given to pack.
+    size_t binsOpened = 0;     // Bins opened so far, including the one being filled.
+    Stats::Stage stage = Stats::Stage::BoundingBoxPacking; // Stage running in the current bin.
+    double elapsedSeconds = 0.0;
+    double etaSeconds = -1.0;  // Estimated time left, from the fraction of the piece area placed; -1 if unknown.
+    bool finished = false;     // True for the last report of a run.
+    bool cancelled = false;    // True if the run was cancelled before placing every piece it could.
+};
+
+using Callback = std::function<void(const Report&)>;
+
+/**
+ * @brief Throttles progress reports of a pack run.
+ * The bins call due() at coarse points of their loops (a piece placed, a stage started) and only
+ * build a report when the interval has elapsed, so the callback stays off the hot paths.
+ */
+class Reporter {
+public:
+    /**
+     * @param callback Called with each report, on the thread running pack.
+     * @param interval Minimum time between two reports.
+     * @param piecesTotal Number of pieces given to pack.
+     * @param areaTotal Summed area of those pieces, used for the ETA.
+     */
+    Reporter(Callback callback, std::chrono::milliseconds interval, size_t piecesTotal, double areaTotal);
+
+    /**
+     * @brief Starts a new bin; the pieces and area placed in earlier bins are kept as a base.
+     */
+    void beginBin(size_t binsOpened, size_t piecesPlacedBefore, double areaPlacedBefore);
+
+    /**
+     * @brief True when the interval since the last report has elapsed.
+     */
+    bool due() const { return std::chrono::steady_clock::now() >= nextReport; }
+
+    /**
+     * @brief Sends a report for the current bin, with the pieces and area it holds now.
+     */
+    void report(size_t piecesInBin, double areaInBin, Stats::Stage stage);
+
+    /**
+     * @brief Sends the last report of the run, with the totals given to the last beginBin().
+     */
+    void finish(bool cancelled);
+
+private:
+    Report makeReport(size_t piecesInBin, double areaInBin, Stats::Stage stage);
+
+    Callback callback;
+    std::chrono::milliseconds interval;
+    size_t piecesTotal;
+    double areaTotal;
+
+    std::chrono::steady_clock::time_point start;
+    std::chrono::steady_clock::time_point nextReport;
+    size_t binsOpened = 0;
+    size_t piecesBefore = 0;
+    double areaBefore = 0.0;
+};
+
+} // namespace Progress
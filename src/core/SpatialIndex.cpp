@@ -0,0 +1,79 @@
+#include "SpatialIndex.h"
+
+using namespace SpatialIndexBackends;
+
+namespace {
+    // Replaces the structure in target with the one in source, moving its allocator along.
+    template <typename Variant>
+    void moveInto(Variant& target, Variant& source) {
+        std::visit([&target](auto& backend) { target.template emplace<std::decay_t<decltype(backend)>>(std::move(backend)); }, source);
+    }
+}
+
+SpatialIndex::Backends SpatialIndex::make(BroadPhase broadPhase, const Rectangle2D& bounds, const Allocator& allocator) {
+    switch (broadPhase) {
+        case BroadPhase::Auto:
+        case BroadPhase::Scan: return Backends(std::in_place_type<ScanIndex>, bounds, allocator);
+        case BroadPhase::Grid: return Backends(std::in_place_type<GridIndex>, bounds, allocator);
+        case BroadPhase::Hash: return Backends(std::in_place_type<HashIndex>, bounds, allocator);
+        case BroadPhase::RTreeLinear: return Backends(std::in_place_type<RTreeLinearIndex>, bounds, allocator);
+        case BroadPhase::RTreeQuadratic: return Backends(std::in_place_type<RTreeQuadraticIndex>, bounds, allocator);
+        case BroadPhase::RTreeRStar: return Backends(std::in_place_type<RTreeRStarIndex>, bounds, allocator);
+    }
+    return Backends(std::in_place_type<ScanIndex>, bounds, allocator);
+}
+
+SpatialIndex::SpatialIndex(const Rectangle2D& bounds, BroadPhase broadPhase, const Allocator& allocator) :
+    bounds(bounds),
+    broadPhase(broadPhase),
+    allocator(allocator),
+    backend(make(broadPhase, bounds, allocator))
+{}
+
+SpatialIndex::SpatialIndex(const SpatialIndex& other, const Allocator& allocator) :
+    bounds(other.bounds),
+    broadPhase(other.broadPhase),
+    allocator(allocator),
+    backend(std::visit([&allocator](const auto& backend) {
+        using Backend = std::decay_t<decltype(backend)>;
+        return Backends(std::in_place_type<Backend>, backend, allocator);
+    }, other.backend))
+{}
+
+void SpatialIndex::swap(SpatialIndex& other) noexcept {
+    using std::swap;
+    swap(bounds, other.bounds);
+    swap(broadPhase, other.broadPhase);
+    swap(allocator, other.allocator);
+    if (backend.index() == other.backend.index()) {
+        std::visit([&other](auto& backend) {
+            backend.swap(std::get<std::decay_t<decltype(backend)>>(other.backend));
+        }, backend);
+    } else {
+        // The assignments of the variant would not carry the allocators over.
+        Backends tmp(std::move(other.backend));
+        moveInto(other.backend, backend);
+        moveInto(backend, tmp);
+    }
+}
+
+void SpatialIndex::insert(size_t index, const Rectangle2D& box) {
+    std::visit([&](auto& backend) { backend.insert(index, box); }, backend);
+    if (broadPhase == BroadPhase::Auto && choose(size()) != current()) {
+        switchTo(choose(size()));
+    }
+}
+
+void SpatialIndex::remove(size_t index) {
+    std::visit([index](auto& backend) { backend.remove(index); }, backend);
+}
+
+void SpatialIndex::switchTo(BroadPhase target) {
+    Backends replacement = make(target, bounds, allocator);
+    std::visit([&replacement](const auto& backend) {
+        std::visit([&backend](auto& next) {
+            backend.forEach([&next](size_t index, const Rectangle2D& box) { next.insert(index, box); });
+        }, replacement);
+    }, backend);
+    moveInto(backend, replacement);
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "core/PackingConfig.h"
+#include "core/SpatialIndexBackends.h"
+#include <variant>
+
+/**
+ * @brief Broad-phase index of the boxes of the pieces placed in a bin, keyed by piece index.
+ *
+ * A front for the structures of SpatialIndexBackends, chosen by a BroadPhase. All of them report
+ * every box that intersects a query box, touching included, and replace a box in place with
+ * update(). With BroadPhase::Auto the index is a scan up to SCAN_LIMIT boxes and a uniform grid
+ * from there on, the grid sizing its cells after the boxes. On the layouts of
+ * bench_spatial_index the grid answers queries faster than the R-trees and the spatial hash at
+ * every size tried, skewed sizes included, and updates boxes 20 to 60 times faster than the
+ * R-trees; below about 128 boxes the scan beats it.
+ * Storage is allocated through the bin's tracking allocator.
+ */
+class SpatialIndex {
+public:
+    using Allocator = SpatialIndexBackends::Allocator;
+
+    /**
+     * @brief Number of boxes from which the automatic choice is a grid rather than a scan.
+     */
+    static constexpr size_t SCAN_LIMIT = 128;
+
+    /**
+     * @param bounds The region the boxes are expected to lie in, the bin.
+     * @param broadPhase The structure to use, or Auto to choose it from the boxes.
+     * @param allocator Allocator of the storage of the index.
+     */
+    explicit SpatialIndex(const Rectangle2D& bounds, BroadPhase broadPhase = BroadPhase::Auto, const Allocator& allocator = Allocator());
+
+    SpatialIndex(const SpatialIndex& other, const Allocator& allocator);
+    SpatialIndex(SpatialIndex&& other) noexcept = default;
+    SpatialIndex& operator=(const SpatialIndex&) = delete;
+    SpatialIndex& operator=(SpatialIndex&&) = delete;
+
+    /**
+     * @brief Exchanges the contents, allocators included.
+     */
+    void swap(SpatialIndex& other) noexcept;
+
+    /**
+     * @brief Adds the box of a piece that is not indexed yet.
+     */
+    void insert(size_t index, const Rectangle2D& box);
+
+    /**
+     * @brief Removes the box of an indexed piece.
+     */
+    void remove(size_t index);
+
+    /**
+     * @brief Replaces the box of an indexed piece.
+     */
+    void update(size_t index, const Rectangle2D& box) {
+        std::visit([&](auto& backend) { backend.update(index, box); }, backend);
+    }
+
+    bool contains(size_t index) const {
+        return std::visit([index](const auto& backend) { return backend.contains(index); }, backend);
+    }
+
+    size_t size() const {
+        return std::visit([](const auto& backend) { return backend.size(); }, backend);
+    }
+
+    /**
+     * @brief The structure in use, never Auto.
+     */
+    BroadPhase current() const { return static_cast<BroadPhase>(backend.index() + 1); }
+
+    /**
+     * @brief Calls visit(index, box) once for every indexed box that intersects the query box,
+     * touching included, in no particular order. Not reentrant: visit must not change the index.
+     */
+    template <typename Visitor>
+    void query(const Rectangle2D& box, Visitor&& visit) {
+        std::visit([&](auto& backend) { backend.query(box, visit); }, backend);
+    }
+
+    /**
+     * @brief The structure the automatic choice picks for a number of boxes.
+     */
+    static BroadPhase choose(size_t count) { return count < SCAN_LIMIT ? BroadPhase::Scan : BroadPhase::Grid; }
+
+private:
+    // In the order of BroadPhase, after Auto.
+    using Backends = std::variant<SpatialIndexBackends::ScanIndex, SpatialIndexBackends::GridIndex,
+                                  SpatialIndexBackends::HashIndex, SpatialIndexBackends::RTreeLinearIndex,
+                                  SpatialIndexBackends::RTreeQuadraticIndex, SpatialIndexBackends::RTreeRStarIndex>;
+
+    Rectangle2D bounds;
+    BroadPhase broadPhase; // As requested, possibly Auto.
+    Allocator allocator;
+    Backends backend;
+
+    static Backends make(BroadPhase broadPhase, const Rectangle2D& bounds, const Allocator& allocator);
+
+    /**
+     * @brief Moves the boxes into another structure.
+     */
+    void switchTo(BroadPhase broadPhase);
+};
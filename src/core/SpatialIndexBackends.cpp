@@ -0,0 +1,275 @@
+#include "SpatialIndexBackends.h"
+#include <cmath>
+
+namespace SpatialIndexBackends {
+
+// --- ScanIndex ---
+
+ScanIndex::ScanIndex(const Rectangle2D&, const Allocator& allocator) :
+    minX(Memory::TrackingAllocator<double>(allocator)),
+    minY(Memory::TrackingAllocator<double>(allocator)),
+    maxX(Memory::TrackingAllocator<double>(allocator)),
+    maxY(Memory::TrackingAllocator<double>(allocator)),
+    ids(Memory::TrackingAllocator<uint32_t>(allocator)),
+    slots(Memory::TrackingAllocator<uint32_t>(allocator))
+{}
+
+ScanIndex::ScanIndex(const ScanIndex& other, const Allocator& allocator) :
+    minX(other.minX, Memory::TrackingAllocator<double>(allocator)),
+    minY(other.minY, Memory::TrackingAllocator<double>(allocator)),
+    maxX(other.maxX, Memory::TrackingAllocator<double>(allocator)),
+    maxY(other.maxY, Memory::TrackingAllocator<double>(allocator)),
+    ids(other.ids, Memory::TrackingAllocator<uint32_t>(allocator)),
+    slots(other.slots, Memory::TrackingAllocator<uint32_t>(allocator))
+{}
+
+void ScanIndex::swap(ScanIndex& other) noexcept {
+    minX.swap(other.minX);
+    minY.swap(other.minY);
+    maxX.swap(other.maxX);
+    maxY.swap(other.maxY);
+    ids.swap(other.ids);
+    slots.swap(other.slots);
+}
+
+void ScanIndex::insert(size_t index, const Rectangle2D& box) {
+    if (index >= slots.size()) {
+        slots.resize(index + 1, NONE);
+    }
+    slots[index] = static_cast<uint32_t>(ids.size());
+    ids.push_back(static_cast<uint32_t>(index));
+    minX.push_back(box.min_corner().x());
+    minY.push_back(box.min_corner().y());
+    maxX.push_back(box.max_corner().x());
+    maxY.push_back(box.max_corner().y());
+}
+
+void ScanIndex::remove(size_t index) {
+    if (!contains(index)) {
+        return;
+    }
+    // The last box takes the place of the removed one.
+    uint32_t slot = slots[index];
+    size_t last = ids.size() - 1;
+    ids[slot] = ids[last];
+    minX[slot] = minX[last];
+    minY[slot] = minY[last];
+    maxX[slot] = maxX[last];
+    maxY[slot] = maxY[last];
+    slots[ids[slot]] = slot;
+    slots[index] = NONE;
+    ids.pop_back();
+    minX.pop_back();
+    minY.pop_back();
+    maxX.pop_back();
+    maxY.pop_back();
+}
+
+uint64_t ScanIndex::hitMask(const Rectangle2D& box, size_t base) const {
+    const double qMinX = box.min_corner().x(), qMinY = box.min_corner().y();
+    const double qMaxX = box.max_corner().x(), qMaxY = box.max_corner().y();
+    const double* x0 = minX.data() + base;
+    const double* y0 = minY.data() + base;
+    const double* x1 = maxX.data() + base;
+    const double* y1 = maxY.data() + base;
+    const size_t n = std::min(ids.size() - base, BLOCK);
+    uint64_t mask = 0;
+    for (size_t i = 0; i < n; ++i) {
+        uint64_t hit = (x0[i] <= qMaxX) & (qMinX <= x1[i]) & (y0[i] <= qMaxY) & (qMinY <= y1[i]);
+        mask |= hit << i;
+    }
+    return mask;
+}
+
+void ScanIndex::update(size_t index, const Rectangle2D& box) {
+    uint32_t slot = slots[index];
+    minX[slot] = box.min_corner().x();
+    minY[slot] = box.min_corner().y();
+    maxX[slot] = box.max_corner().x();
+    maxY[slot] = box.max_corner().y();
+}
+
+// --- CellIndex ---
+
+template <bool Hashed>
+CellIndex<Hashed>::CellIndex(const Rectangle2D& bounds, const Allocator& allocator) :
+    bounds(bounds),
+    allocator(allocator),
+    entries(Memory::TrackingAllocator<Entry>(allocator)),
+    buckets(Memory::TrackingAllocator<Bucket>(allocator))
+{
+    double side = std::max(RectangleUtils::getWidth(bounds), RectangleUtils::getHeight(bounds));
+    resize(side / 8);
+}
+
+template <bool Hashed>
+CellIndex<Hashed>::CellIndex(const CellIndex& other, const Allocator& allocator) :
+    bounds(other.bounds),
+    allocator(allocator),
+    cellWidth(other.cellWidth),
+    cellHeight(other.cellHeight),
+    cellsX(other.cellsX),
+    cellsY(other.cellsY),
+    bucketMask(other.bucketMask),
+    entries(other.entries, Memory::TrackingAllocator<Entry>(allocator)),
+    buckets(Memory::TrackingAllocator<Bucket>(allocator)),
+    count(other.count),
+    nextRebuild(other.nextRebuild),
+    stamp(other.stamp)
+{
+    buckets.reserve(other.buckets.size());
+    for (const auto& b : other.buckets) {
+        buckets.emplace_back(b, Memory::TrackingAllocator<uint32_t>(allocator));
+    }
+}
+
+template <bool Hashed>
+void CellIndex<Hashed>::swap(CellIndex& other) noexcept {
+    using std::swap;
+    swap(bounds, other.bounds);
+    swap(allocator, other.allocator);
+    swap(cellWidth, other.cellWidth);
+    swap(cellHeight, other.cellHeight);
+    swap(cellsX, other.cellsX);
+    swap(cellsY, other.cellsY);
+    swap(bucketMask, other.bucketMask);
+    entries.swap(other.entries);
+    buckets.swap(other.buckets);
+    swap(count, other.count);
+    swap(nextRebuild, other.nextRebuild);
+    swap(stamp, other.stamp);
+}
+
+template <bool Hashed>
+int64_t CellIndex<Hashed>::cellX(double x) const {
+    double cell = std::floor((x - RectangleUtils::getX(bounds)) / cellWidth);
+    if constexpr (Hashed) {
+        return static_cast<int64_t>(cell);
+    } else {
+        return static_cast<int64_t>(std::clamp(cell, 0.0, static_cast<double>(cellsX - 1)));
+    }
+}
+
+template <bool Hashed>
+int64_t CellIndex<Hashed>::cellY(double y) const {
+    double cell = std::floor((y - RectangleUtils::getY(bounds)) / cellHeight);
+    if constexpr (Hashed) {
+        return static_cast<int64_t>(cell);
+    } else {
+        return static_cast<int64_t>(std::clamp(cell, 0.0, static_cast<double>(cellsY - 1)));
+    }
+}
+
+template <bool Hashed>
+void CellIndex<Hashed>::link(uint32_t index, const CellRange& range) {
+    for (int64_t y = range.minY; y <= range.maxY; ++y) {
+        for (int64_t x = range.minX; x <= range.maxX; ++x) {
+            buckets[bucket(x, y)].push_back(index);
+        }
+    }
+}
+
+template <bool Hashed>
+void CellIndex<Hashed>::unlink(uint32_t index, const CellRange& range) {
+    // A bucket of the hash may list an entry once for each of its cells that hash there;
+    // every cell takes one of them back.
+    for (int64_t y = range.minY; y <= range.maxY; ++y) {
+        for (int64_t x = range.minX; x <= range.maxX; ++x) {
+            Bucket& b = buckets[bucket(x, y)];
+            auto it = std::find(b.begin(), b.end(), index);
+            if (it != b.end()) {
+                *it = b.back();
+                b.pop_back();
+            }
+        }
+    }
+}
+
+template <bool Hashed>
+void CellIndex<Hashed>::insert(size_t index, const Rectangle2D& box) {
+    if (index >= entries.size()) {
+        entries.resize(index + 1);
+    }
+    Entry& entry = entries[index];
+    entry.box = box;
+    entry.range = cellRange(box);
+    entry.present = true;
+    link(static_cast<uint32_t>(index), entry.range);
+    if (++count >= nextRebuild) {
+        rebuild();
+    }
+}
+
+template <bool Hashed>
+void CellIndex<Hashed>::remove(size_t index) {
+    if (!contains(index)) {
+        return;
+    }
+    Entry& entry = entries[index];
+    unlink(static_cast<uint32_t>(index), entry.range);
+    entry.present = false;
+    count--;
+    while (!entries.empty() && !entries.back().present) {
+        entries.pop_back();
+    }
+}
+
+template <bool Hashed>
+void CellIndex<Hashed>::update(size_t index, const Rectangle2D& box) {
+    Entry& entry = entries[index];
+    CellRange range = cellRange(box);
+    if (!(range == entry.range)) {
+        unlink(static_cast<uint32_t>(index), entry.range);
+        link(static_cast<uint32_t>(index), range);
+        entry.range = range;
+    }
+    entry.box = box;
+}
+
+template <bool Hashed>
+void CellIndex<Hashed>::rebuild() {
+    double extent = 0;
+    for (const auto& entry : entries) {
+        if (entry.present) {
+            extent += (RectangleUtils::getWidth(entry.box) + RectangleUtils::getHeight(entry.box)) / 2;
+        }
+    }
+    resize(extent / static_cast<double>(count));
+    for (size_t i = 0; i < entries.size(); ++i) {
+        if (entries[i].present) {
+            entries[i].range = cellRange(entries[i].box);
+            link(static_cast<uint32_t>(i), entries[i].range);
+        }
+    }
+    nextRebuild = 2 * count;
+}
+
+template <bool Hashed>
+void CellIndex<Hashed>::resize(double cellSize) {
+    double width = RectangleUtils::getWidth(bounds);
+    double height = RectangleUtils::getHeight(bounds);
+    auto cellsAlong = [cellSize](double length) {
+        double n = cellSize > 0 ? std::ceil(length / cellSize) : 1.0;
+        return static_cast<int64_t>(std::clamp(n, 1.0, static_cast<double>(MAX_CELLS_PER_SIDE)));
+    };
+    cellsX = cellsAlong(width);
+    cellsY = cellsAlong(height);
+    cellWidth = width > 0 ? width / static_cast<double>(cellsX) : 1.0;
+    cellHeight = height > 0 ? height / static_cast<double>(cellsY) : 1.0;
+
+    size_t bucketCount = static_cast<size_t>(cellsX * cellsY);
+    if constexpr (Hashed) {
+        bucketCount = 64;
+        while (bucketCount < 2 * count) {
+            bucketCount *= 2;
+        }
+        bucketMask = bucketCount - 1;
+    }
+    buckets.clear();
+    buckets.resize(bucketCount, Bucket(Memory::TrackingAllocator<uint32_t>(allocator)));
+}
+
+template class CellIndex<false>;
+template class CellIndex<true>;
+
+} // namespace SpatialIndexBackends
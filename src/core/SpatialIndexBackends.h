@@ -0,0 +1,306 @@
+#pragma once
+
+#include "core/Memory.h"
+#include "primitives/Rectangle.h"
+#include <algorithm>
+#include <boost/geometry/index/rtree.hpp>
+#include <boost/iterator/function_output_iterator.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief The interchangeable structures behind SpatialIndex.
+ *
+ * Each maps piece indices to boxes with the same interface: insert, remove and update by index,
+ * query(box, visit(index, box)) reporting every box that intersects the query box (touching
+ * included) exactly once, and forEach(visit(index, box)) over all of them. Storage is allocated
+ * through the allocator given at construction, swap exchanges the allocators too, and copies
+ * take a new allocator.
+ */
+namespace SpatialIndexBackends {
+
+using Allocator = Memory::TrackingAllocator<char>;
+
+template <typename T>
+using Vector = std::vector<T, Memory::TrackingAllocator<T>>;
+
+inline bool intersects(const Rectangle2D& a, const Rectangle2D& b) {
+    return a.min_corner().x() <= b.max_corner().x() && b.min_corner().x() <= a.max_corner().x() &&
+           a.min_corner().y() <= b.max_corner().y() && b.min_corner().y() <= a.max_corner().y();
+}
+
+/**
+ * @brief Linear scan over the boxes, stored as four arrays of coordinates.
+ *
+ * The query tests a block of 64 boxes without branches into a bit mask, which the compiler
+ * vectorizes, and then reports the set bits. Writing the hits to a list as they are found
+ * instead makes every store wait for the previous comparison, four times slower. There is no
+ * structure to maintain, so it is the fastest choice while a bin holds few pieces.
+ */
+class ScanIndex {
+public:
+    explicit ScanIndex(const Rectangle2D& bounds, const Allocator& allocator = Allocator());
+    ScanIndex(const ScanIndex& other, const Allocator& allocator);
+    ScanIndex(ScanIndex&& other) noexcept = default;
+    ScanIndex& operator=(const ScanIndex&) = delete;
+    ScanIndex& operator=(ScanIndex&&) = delete;
+    void swap(ScanIndex& other) noexcept;
+
+    void insert(size_t index, const Rectangle2D& box);
+    void remove(size_t index);
+    void update(size_t index, const Rectangle2D& box);
+    bool contains(size_t index) const { return index < slots.size() && slots[index] != NONE; }
+    size_t size() const { return ids.size(); }
+
+    template <typename Visitor>
+    void query(const Rectangle2D& box, Visitor&& visit) const {
+        for (size_t base = 0; base < ids.size(); base += BLOCK) {
+            for (uint64_t hits = hitMask(box, base); hits != 0; hits &= hits - 1) {
+                size_t slot = base + static_cast<size_t>(__builtin_ctzll(hits));
+                visit(static_cast<size_t>(ids[slot]), boxAt(slot));
+            }
+        }
+    }
+
+    template <typename Visitor>
+    void forEach(Visitor&& visit) const {
+        for (size_t i = 0; i < ids.size(); ++i) {
+            visit(static_cast<size_t>(ids[i]), boxAt(i));
+        }
+    }
+
+private:
+    static constexpr size_t BLOCK = 64;
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    Vector<double> minX, minY, maxX, maxY;
+    Vector<uint32_t> ids;   // Piece index of each slot.
+    Vector<uint32_t> slots; // Slot of each piece index, NONE if absent.
+
+    /**
+     * @brief Bit i is set if the box in slot base + i meets the query box.
+     */
+    uint64_t hitMask(const Rectangle2D& box, size_t base) const;
+
+    Rectangle2D boxAt(size_t slot) const {
+        return Rectangle2D(MPointDouble(minX[slot], minY[slot]), MPointDouble(maxX[slot], maxY[slot]));
+    }
+};
+
+/**
+ * @brief Grid of square-ish cells listing the boxes that overlap them.
+ *
+ * The cell size follows the mean size of the indexed boxes, the cells being rebuilt as their
+ * number doubles, and is never below 1/64 of the larger side of the bounds. Moving a box only
+ * touches the cells when it crosses into other ones, so update() is a single assignment for
+ * the unit steps of compress. A query walks the cells its box overlaps, skipping the boxes
+ * already reported through another cell.
+ *
+ * With Hashed false the cells tile the bounds and boxes outside them fall in the border cells:
+ * a uniform grid, whose memory grows with the area covered. With Hashed true the cells extend
+ * without limit and are hashed into a power-of-two number of buckets, about twice the number
+ * of boxes: a spatial hash, whose memory grows with the number of pieces.
+ */
+template <bool Hashed>
+class CellIndex {
+public:
+    explicit CellIndex(const Rectangle2D& bounds, const Allocator& allocator = Allocator());
+    CellIndex(const CellIndex& other, const Allocator& allocator);
+    CellIndex(CellIndex&& other) noexcept = default;
+    CellIndex& operator=(const CellIndex&) = delete;
+    CellIndex& operator=(CellIndex&&) = delete;
+    void swap(CellIndex& other) noexcept;
+
+    void insert(size_t index, const Rectangle2D& box);
+    void remove(size_t index);
+    void update(size_t index, const Rectangle2D& box);
+    bool contains(size_t index) const { return index < entries.size() && entries[index].present; }
+    size_t size() const { return count; }
+
+    template <typename Visitor>
+    void query(const Rectangle2D& box, Visitor&& visit) {
+        if (count == 0) {
+            return;
+        }
+        CellRange range = cellRange(box);
+        if (++stamp == 0) { // Wrapped around: forget every mark.
+            for (auto& entry : entries) {
+                entry.stamp = 0;
+            }
+            stamp = 1;
+        }
+        for (int64_t y = range.minY; y <= range.maxY; ++y) {
+            for (int64_t x = range.minX; x <= range.maxX; ++x) {
+                for (uint32_t index : buckets[bucket(x, y)]) {
+                    Entry& entry = entries[index];
+                    if (entry.stamp == stamp) {
+                        continue; // Listed in an earlier cell of this query.
+                    }
+                    entry.stamp = stamp;
+                    if (intersects(entry.box, box)) {
+                        visit(static_cast<size_t>(index), entry.box);
+                    }
+                }
+            }
+        }
+    }
+
+    template <typename Visitor>
+    void forEach(Visitor&& visit) const {
+        for (size_t i = 0; i < entries.size(); ++i) {
+            if (entries[i].present) {
+                visit(i, entries[i].box);
+            }
+        }
+    }
+
+private:
+    using Bucket = Vector<uint32_t>;
+
+    struct CellRange {
+        int64_t minX, minY, maxX, maxY;
+
+        bool operator==(const CellRange& other) const {
+            return minX == other.minX && minY == other.minY && maxX == other.maxX && maxY == other.maxY;
+        }
+    };
+
+    struct Entry {
+        Rectangle2D box;
+        CellRange range{0, 0, 0, 0};
+        uint32_t stamp = 0; // Query that last reported the entry.
+        bool present = false;
+    };
+
+    static constexpr int64_t MAX_CELLS_PER_SIDE = 64;
+    static constexpr size_t FIRST_REBUILD = 8;
+
+    Rectangle2D bounds;
+    Allocator allocator;
+    double cellWidth;
+    double cellHeight;
+    int64_t cellsX; // Columns and rows of the grid; for the hash, of the cells covering the bounds.
+    int64_t cellsY;
+    size_t bucketMask = 0; // Hash only: number of buckets - 1.
+    Vector<Entry> entries;
+    Vector<Bucket> buckets;
+    size_t count = 0;
+    size_t nextRebuild = FIRST_REBUILD;
+    uint32_t stamp = 0;
+
+    int64_t cellX(double x) const;
+    int64_t cellY(double y) const;
+    CellRange cellRange(const Rectangle2D& box) const {
+        return {cellX(box.min_corner().x()), cellY(box.min_corner().y()), cellX(box.max_corner().x()), cellY(box.max_corner().y())};
+    }
+
+    size_t bucket(int64_t x, int64_t y) const {
+        if constexpr (Hashed) {
+            uint64_t h = static_cast<uint64_t>(x) * 0x9E3779B97F4A7C15ull ^ static_cast<uint64_t>(y) * 0xC2B2AE3D27D4EB4Full;
+            return static_cast<size_t>(h ^ (h >> 29)) & bucketMask;
+        } else {
+            return static_cast<size_t>(y * cellsX + x);
+        }
+    }
+
+    void link(uint32_t index, const CellRange& range);
+    void unlink(uint32_t index, const CellRange& range);
+
+    /**
+     * @brief Sizes the cells after the mean box of the entries and lists every entry again.
+     */
+    void rebuild();
+    void resize(double cellSize);
+};
+
+extern template class CellIndex<false>;
+extern template class CellIndex<true>;
+
+using GridIndex = CellIndex<false>;
+using HashIndex = CellIndex<true>;
+
+/**
+ * @brief Boost R-tree with the given splitting algorithm (e.g. boost::geometry::index::rstar<16>).
+ * An update is a removal and an insertion.
+ */
+template <typename Parameters>
+class RTreeIndex {
+public:
+    explicit RTreeIndex(const Rectangle2D&, const Allocator& allocator = Allocator()) :
+        tree(Parameters(), Indexable(), EqualTo(), ValueAllocator(allocator)),
+        boxes(Memory::TrackingAllocator<Slot>(allocator)) {}
+
+    RTreeIndex(const RTreeIndex& other, const Allocator& allocator) :
+        tree(other.tree, ValueAllocator(allocator)),
+        boxes(other.boxes, Memory::TrackingAllocator<Slot>(allocator)) {}
+
+    RTreeIndex(RTreeIndex&& other) noexcept = default;
+    RTreeIndex& operator=(const RTreeIndex&) = delete;
+    RTreeIndex& operator=(RTreeIndex&&) = delete;
+
+    void swap(RTreeIndex& other) noexcept {
+        tree.swap(other.tree);
+        boxes.swap(other.boxes);
+    }
+
+    void insert(size_t index, const Rectangle2D& box) {
+        if (index >= boxes.size()) {
+            boxes.resize(index + 1);
+        }
+        boxes[index] = {box, true};
+        tree.insert({box, index});
+    }
+
+    void remove(size_t index) {
+        if (contains(index)) {
+            tree.remove({boxes[index].box, index});
+            boxes[index].present = false;
+        }
+    }
+
+    void update(size_t index, const Rectangle2D& box) {
+        tree.remove({boxes[index].box, index});
+        boxes[index].box = box;
+        tree.insert({box, index});
+    }
+
+    bool contains(size_t index) const { return index < boxes.size() && boxes[index].present; }
+    size_t size() const { return tree.size(); }
+
+    template <typename Visitor>
+    void query(const Rectangle2D& box, Visitor&& visit) const {
+        tree.query(boost::geometry::index::intersects(box),
+                   boost::make_function_output_iterator([&visit](const Value& value) { visit(value.second, value.first); }));
+    }
+
+    template <typename Visitor>
+    void forEach(Visitor&& visit) const {
+        for (size_t i = 0; i < boxes.size(); ++i) {
+            if (boxes[i].present) {
+                visit(i, boxes[i].box);
+            }
+        }
+    }
+
+private:
+    using Value = std::pair<Rectangle2D, size_t>;
+    using Indexable = boost::geometry::index::indexable<Value>;
+    using EqualTo = boost::geometry::index::equal_to<Value>;
+    using ValueAllocator = Memory::TrackingAllocator<Value>;
+    using Tree = boost::geometry::index::rtree<Value, Parameters, Indexable, EqualTo, ValueAllocator>;
+
+    struct Slot {
+        Rectangle2D box;
+        bool present = false;
+    };
+
+    Tree tree;
+    Vector<Slot> boxes; // The box under which each piece is stored, to remove it.
+};
+
+using RTreeLinearIndex = RTreeIndex<boost::geometry::index::linear<16>>;
+using RTreeQuadraticIndex = RTreeIndex<boost::geometry::index::quadratic<16>>;
+using RTreeRStarIndex = RTreeIndex<boost::geometry::index::rstar<16>>;
+
+} // namespace SpatialIndexBackends
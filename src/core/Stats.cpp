@@ -0,0 +1,302 @@
+#include "Stats.h"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+namespace Stats {
+
+const char* stageName(Stage stage) {
+    switch (stage) {
+        case Stage::BoundingBoxPacking: return "boundingBoxPacking";
+        case Stage::MoveAndReplace: return "moveAndReplace";
+        case Stage::Compress: return "compress";
+        case Stage::DropPieces: return "dropPieces";
+    }
+    return "unknown";
+}
+
+const char* memoryCategoryName(MemoryCategory category) {
+    switch (category) {
+        case MemoryCategory::PlacedPieces: return "placedPieces";
+        case MemoryCategory::RTree: return "rtree";
+        case MemoryCategory::FreeRectangles: return "freeRectangles";
+        case MemoryCategory::Temporary: return "temporary";
+    }
+    return "unknown";
+}
+
+Counters& Counters::operator+=(const Counters& other) {
+    rtreeQueries += other.rtreeQueries;
+    broadPhaseCandidates += other.broadPhaseCandidates;
+    narrowPhaseTests += other.narrowPhaseTests;
+    compressSteps += other.compressSteps;
+    sweepCells += other.sweepCells;
+    diveSlots += other.diveSlots;
+    freeRectanglesHighWater = std::max(freeRectanglesHighWater, other.freeRectanglesHighWater);
+    return *this;
+}
+
+Counters BinStats::total() const {
+    Counters sum;
+    for (const auto& counters : stages) {
+        sum += counters;
+    }
+    return sum;
+}
+
+uint64_t MemoryUsage::currentTotalBytes() const {
+    uint64_t sum = 0;
+    for (uint64_t bytes : currentBytes) {
+        sum += bytes;
+    }
+    return sum;
+}
+
+MemoryUsage& MemoryUsage::operator+=(const MemoryUsage& other) {
+    for (size_t c = 0; c < MEMORY_CATEGORY_COUNT; ++c) {
+        peakBytes[c] += other.peakBytes[c];
+        currentBytes[c] += other.currentBytes[c];
+    }
+    peakTotalBytes += other.peakTotalBytes;
+    return *this;
+}
+
+MemoryUsage BinStats::memoryTotal() const {
+    MemoryUsage result;
+    for (const auto& usage : memory) {
+        for (size_t c = 0; c < MEMORY_CATEGORY_COUNT; ++c) {
+            result.peakBytes[c] = std::max(result.peakBytes[c], usage.peakBytes[c]);
+        }
+        result.peakTotalBytes = std::max(result.peakTotalBytes, usage.peakTotalBytes);
+    }
+    result.currentBytes = currentBytes;
+    return result;
+}
+
+size_t LatencyHistogram::bucketIndex(uint64_t nanoseconds) {
+    if (nanoseconds < SUB_BUCKETS) {
+        return static_cast<size_t>(nanoseconds);
+    }
+    unsigned exponent = 63 - static_cast<unsigned>(__builtin_clzll(nanoseconds));
+    if (exponent > MAX_EXPONENT) {
+        return BUCKET_COUNT - 1;
+    }
+    uint64_t sub = (nanoseconds >> (exponent - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1);
+    return static_cast<size_t>(SUB_BUCKETS + (exponent - SUB_BUCKET_BITS) * SUB_BUCKETS + sub);
+}
+
+uint64_t LatencyHistogram::bucketLowerBound(size_t index) {
+    if (index < SUB_BUCKETS) {
+        return index;
+    }
+    uint64_t exponent = (index - SUB_BUCKETS) / SUB_BUCKETS + SUB_BUCKET_BITS;
+    uint64_t sub = (index - SUB_BUCKETS) % SUB_BUCKETS;
+    return (SUB_BUCKETS + sub) << (exponent - SUB_BUCKET_BITS);
+}
+
+uint64_t LatencyHistogram::bucketUpperBound(size_t index) {
+    return index + 1 < BUCKET_COUNT ? bucketLowerBound(index + 1) - 1 : UINT64_MAX;
+}
+
+void LatencyHistogram::record(uint64_t nanoseconds) {
+    counts[bucketIndex(nanoseconds)]++;
+    samples++;
+    minNs = std::min(minNs, nanoseconds);
+    maxNs = std::max(maxNs, nanoseconds);
+    sumNs += nanoseconds;
+}
+
+uint64_t LatencyHistogram::percentile(double q) const {
+    if (samples == 0) {
+        return 0;
+    }
+    uint64_t rank = static_cast<uint64_t>(std::ceil(std::clamp(q, 0.0, 1.0) * samples));
+    rank = std::max<uint64_t>(rank, 1);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        seen += counts[i];
+        if (seen >= rank) {
+            return std::clamp(bucketUpperBound(i), min(), maxNs);
+        }
+    }
+    return maxNs;
+}
+
+LatencyHistogram& LatencyHistogram::operator+=(const LatencyHistogram& other) {
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        counts[i] += other.counts[i];
+    }
+    samples += other.samples;
+    minNs = std::min(minNs, other.minNs);
+    maxNs = std::max(maxNs, other.maxNs);
+    sumNs += other.sumNs;
+    return *this;
+}
+
+size_t vertexBucket(size_t vertexCount) {
+    size_t bucket = 0;
+    for (size_t limit = 16; bucket + 1 < VERTEX_BUCKET_COUNT && vertexCount >= limit; limit *= 4) {
+        bucket++;
+    }
+    return bucket;
+}
+
+std::string vertexBucketName(size_t bucket) {
+    size_t lower = bucket == 0 ? 0 : size_t(4) << (2 * bucket);
+    if (bucket + 1 >= VERTEX_BUCKET_COUNT) {
+        return std::to_string(lower) + "+";
+    }
+    size_t upper = size_t(4) << (2 * (bucket + 1));
+    return std::to_string(lower) + "-" + std::to_string(upper - 1);
+}
+
+std::array<Counters, STAGE_COUNT> PackStats::stageTotals() const {
+    std::array<Counters, STAGE_COUNT> totals;
+    for (const auto& bin : bins) {
+        for (size_t s = 0; s < STAGE_COUNT; ++s) {
+            totals[s] += bin.stages[s];
+        }
+    }
+    return totals;
+}
+
+Counters PackStats::total() const {
+    Counters sum;
+    for (const auto& bin : bins) {
+        sum += bin.total();
+    }
+    return sum;
+}
+
+std::array<MemoryUsage, STAGE_COUNT> PackStats::stageMemoryTotals() const {
+    std::array<MemoryUsage, STAGE_COUNT> totals;
+    for (const auto& bin : bins) {
+        for (size_t s = 0; s < STAGE_COUNT; ++s) {
+            totals[s] += bin.memory[s];
+        }
+    }
+    return totals;
+}
+
+MemoryUsage PackStats::memoryTotal() const {
+    MemoryUsage sum;
+    for (const auto& bin : bins) {
+        sum += bin.memoryTotal();
+    }
+    return sum;
+}
+
+std::array<LatencyByVertices, STAGE_COUNT> PackStats::stageLatencyTotals() const {
+    std::array<LatencyByVertices, STAGE_COUNT> totals;
+    for (const auto& bin : bins) {
+        for (size_t s = 0; s < STAGE_COUNT; ++s) {
+            for (size_t v = 0; v < VERTEX_BUCKET_COUNT; ++v) {
+                totals[s][v] += bin.latency[s][v];
+            }
+        }
+    }
+    return totals;
+}
+
+namespace {
+    void writeHeader(std::ostringstream& out, const char* firstColumn) {
+        out << std::left << std::setw(20) << firstColumn << std::right
+            << std::setw(14) << "rtreeQueries"
+            << std::setw(14) << "candidates"
+            << std::setw(14) << "narrowPhase"
+            << std::setw(14) << "compressSteps"
+            << std::setw(12) << "sweepCells"
+            << std::setw(12) << "diveSlots"
+            << std::setw(12) << "freeRectsHW" << "\n";
+    }
+
+    void writeRow(std::ostringstream& out, const std::string& label, const Counters& c) {
+        out << std::left << std::setw(20) << label << std::right
+            << std::setw(14) << c.rtreeQueries
+            << std::setw(14) << c.broadPhaseCandidates
+            << std::setw(14) << c.narrowPhaseTests
+            << std::setw(14) << c.compressSteps
+            << std::setw(12) << c.sweepCells
+            << std::setw(12) << c.diveSlots
+            << std::setw(12) << c.freeRectanglesHighWater << "\n";
+    }
+
+    void writeMemoryHeader(std::ostringstream& out, const char* firstColumn) {
+        out << std::left << std::setw(20) << firstColumn << std::right;
+        for (size_t c = 0; c < MEMORY_CATEGORY_COUNT; ++c) {
+            out << std::setw(16) << memoryCategoryName(static_cast<MemoryCategory>(c));
+        }
+        out << std::setw(14) << "peakTotal" << std::setw(14) << "current" << "\n";
+    }
+
+    void writeMemoryRow(std::ostringstream& out, const std::string& label, const MemoryUsage& m) {
+        out << std::left << std::setw(20) << label << std::right;
+        for (uint64_t bytes : m.peakBytes) {
+            out << std::setw(16) << bytes;
+        }
+        out << std::setw(14) << m.peakTotalBytes << std::setw(14) << m.currentTotalBytes() << "\n";
+    }
+
+    void writeLatencyHeader(std::ostringstream& out) {
+        out << std::left << std::setw(20) << "stage" << std::setw(12) << "vertices" << std::right
+            << std::setw(10) << "pieces" << std::setw(12) << "mean" << std::setw(12) << "p50"
+            << std::setw(12) << "p90" << std::setw(12) << "p99" << std::setw(12) << "max" << "\n";
+    }
+
+    void writeLatencyRow(std::ostringstream& out, const std::string& stage, const std::string& vertices, const LatencyHistogram& h) {
+        auto us = [](double ns) { return ns / 1000.0; };
+        out << std::left << std::setw(20) << stage << std::setw(12) << vertices << std::right
+            << std::setw(10) << h.count() << std::fixed << std::setprecision(1)
+            << std::setw(12) << us(h.mean()) << std::setw(12) << us(h.percentile(0.5))
+            << std::setw(12) << us(h.percentile(0.9)) << std::setw(12) << us(h.percentile(0.99))
+            << std::setw(12) << us(h.max()) << "\n";
+        out.unsetf(std::ios_base::floatfield);
+        out << std::setprecision(6);
+    }
+}
+
+std::string PackStats::report() const {
+    std::ostringstream out;
+    out << "Per stage (" << bins.size() << " bins):\n";
+    writeHeader(out, "stage");
+    auto totals = stageTotals();
+    for (size_t s = 0; s < STAGE_COUNT; ++s) {
+        writeRow(out, stageName(static_cast<Stage>(s)), totals[s]);
+    }
+    writeRow(out, "total", total());
+
+    out << "Per bin:\n";
+    writeHeader(out, "bin");
+    for (size_t i = 0; i < bins.size(); ++i) {
+        writeRow(out, std::to_string(i + 1), bins[i].total());
+    }
+
+    out << "Peak memory per stage, in bytes (" << bins.size() << " bins):\n";
+    writeMemoryHeader(out, "stage");
+    auto memoryTotals = stageMemoryTotals();
+    for (size_t s = 0; s < STAGE_COUNT; ++s) {
+        writeMemoryRow(out, stageName(static_cast<Stage>(s)), memoryTotals[s]);
+    }
+    writeMemoryRow(out, "total", memoryTotal());
+
+    out << "Peak memory per bin, in bytes:\n";
+    writeMemoryHeader(out, "bin");
+    for (size_t i = 0; i < bins.size(); ++i) {
+        writeMemoryRow(out, std::to_string(i + 1), bins[i].memoryTotal());
+    }
+
+    out << "Placement latency per stage and vertex count, in microseconds (" << bins.size() << " bins):\n";
+    writeLatencyHeader(out);
+    auto latencyTotals = stageLatencyTotals();
+    for (size_t s = 0; s < STAGE_COUNT; ++s) {
+        for (size_t v = 0; v < VERTEX_BUCKET_COUNT; ++v) {
+            if (latencyTotals[s][v].count() > 0) {
+                writeLatencyRow(out, stageName(static_cast<Stage>(s)), vertexBucketName(v), latencyTotals[s][v]);
+            }
+        }
+    }
+    return out.str();
+}
+
+} // namespace Stats
@@ -0,0 +1,215 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Hot-path counters, heap usage and placement latency collected by every Bin during a pack run.
+ * They are plain integers updated inline, so they are always compiled in.
+ */
+namespace Stats {
+
+/**
+ * @brief The stages of the packing pipeline, as run by BinPacking::pack.
+ * Work done by helpers (compressPiece, dive, sweep) is attributed to the stage that called them.
+ */
+enum class Stage {
+    BoundingBoxPacking = 0,
+    MoveAndReplace,
+    Compress,
+    DropPieces
+};
+
+constexpr size_t STAGE_COUNT = 4;
+
+/**
+ * @brief Human readable name of a stage, as used in the reports.
+ */
+const char* stageName(Stage stage);
+
+/**
+ * @brief Counters for a single stage of a single bin.
+ */
+struct Counters {
+    uint64_t rtreeQueries = 0;          // Broad-phase queries issued to the spatial index.
+    uint64_t broadPhaseCandidates = 0;  // Candidates returned by those queries.
+    uint64_t narrowPhaseTests = 0;      // Exact intersection tests (bg::intersects) performed.
+    uint64_t compressSteps = 0;         // Unit moves attempted by compressPiece.
+    uint64_t sweepCells = 0;            // Grid positions visited by sweep.
+    uint64_t diveSlots = 0;             // Horizontal start positions tried by dive.
+    uint64_t freeRectanglesHighWater = 0; // Largest free-rectangle list seen (before pruning).
+
+    /**
+     * @brief Accumulates another set of counters. High-water marks are merged with max.
+     */
+    Counters& operator+=(const Counters& other);
+};
+
+/**
+ * @brief What the bytes accounted by a bin are used for.
+ */
+enum class MemoryCategory {
+    PlacedPieces = 0, // The placed pieces, including their vertex storage.
+    RTree,            // Nodes of the spatial index.
+    FreeRectangles,   // The maximal free rectangles.
+    Temporary         // Scratch buffers of computeFreeRectangles, isCollision and sweep.
+};
+
+constexpr size_t MEMORY_CATEGORY_COUNT = 4;
+
+/**
+ * @brief Human readable name of a memory category, as used in the reports.
+ */
+const char* memoryCategoryName(MemoryCategory category);
+
+/**
+ * @brief Heap usage of a single stage of a single bin, in bytes.
+ */
+struct MemoryUsage {
+    std::array<uint64_t, MEMORY_CATEGORY_COUNT> peakBytes{};    // Peak of each category while the stage ran.
+    std::array<uint64_t, MEMORY_CATEGORY_COUNT> currentBytes{}; // Bytes held when the stage last finished (or now, if running).
+    uint64_t peakTotalBytes = 0; // Peak of the sum over all categories, at most the sum of the peaks.
+
+    uint64_t currentTotalBytes() const;
+
+    /**
+     * @brief Sums two usages, for bins that are alive at the same time.
+     * The sum of the peaks is an upper bound of the peak of the sum.
+     */
+    MemoryUsage& operator+=(const MemoryUsage& other);
+};
+
+/**
+ * @brief Log-bucketed histogram of durations in nanoseconds, in the style of HdrHistogram.
+ * Each power of two is split into SUB_BUCKETS linear sub-buckets, so every recorded value is
+ * known within 1/SUB_BUCKETS of itself whatever its magnitude; values below SUB_BUCKETS ns are
+ * exact and values above the last bucket are clamped into it.
+ */
+class LatencyHistogram {
+public:
+    static constexpr unsigned SUB_BUCKET_BITS = 2;
+    static constexpr uint64_t SUB_BUCKETS = uint64_t(1) << SUB_BUCKET_BITS;
+    static constexpr unsigned MAX_EXPONENT = 39; // Last power of two covered, about 9 minutes.
+    static constexpr size_t BUCKET_COUNT = SUB_BUCKETS + (MAX_EXPONENT - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+    void record(uint64_t nanoseconds);
+
+    uint64_t count() const { return samples; }
+    uint64_t min() const { return samples ? minNs : 0; }
+    uint64_t max() const { return maxNs; }
+    uint64_t sum() const { return sumNs; }
+    double mean() const { return samples ? static_cast<double>(sumNs) / samples : 0.0; }
+
+    /**
+     * @brief Smallest recorded value v such that a fraction q of the samples are <= v, up to the
+     * bucket resolution (the upper bound of the bucket, capped by the maximum). 0 if empty.
+     */
+    uint64_t percentile(double q) const;
+
+    const std::array<uint64_t, BUCKET_COUNT>& buckets() const { return counts; }
+
+    static size_t bucketIndex(uint64_t nanoseconds);
+    static uint64_t bucketLowerBound(size_t index);
+    static uint64_t bucketUpperBound(size_t index); // Inclusive.
+
+    LatencyHistogram& operator+=(const LatencyHistogram& other);
+
+private:
+    std::array<uint64_t, BUCKET_COUNT> counts{};
+    uint64_t samples = 0;
+    uint64_t minNs = UINT64_MAX;
+    uint64_t maxNs = 0;
+    uint64_t sumNs = 0;
+};
+
+/**
+ * @brief Pieces are grouped by vertex count for the latency histograms:
+ * [0, 16), [16, 64), [64, 256), [256, 1024) and 1024 or more, holes included.
+ */
+constexpr size_t VERTEX_BUCKET_COUNT = 5;
+
+size_t vertexBucket(size_t vertexCount);
+
+/**
+ * @brief Label of a vertex bucket, e.g. "16-63" or "1024+".
+ */
+std::string vertexBucketName(size_t bucket);
+
+/**
+ * @brief One histogram per vertex bucket.
+ */
+using LatencyByVertices = std::array<LatencyHistogram, VERTEX_BUCKET_COUNT>;
+
+/**
+ * @brief Per-stage counters of a single bin.
+ */
+struct BinStats {
+    std::array<Counters, STAGE_COUNT> stages;
+    std::array<MemoryUsage, STAGE_COUNT> memory;
+    std::array<uint64_t, MEMORY_CATEGORY_COUNT> currentBytes{}; // Bytes held by the bin now.
+    std::array<LatencyByVertices, STAGE_COUNT> latency; // Time spent on each piece, by stage and vertex bucket.
+
+    const Counters& stage(Stage s) const { return stages[static_cast<size_t>(s)]; }
+    Counters& stage(Stage s) { return stages[static_cast<size_t>(s)]; }
+
+    const MemoryUsage& stageMemory(Stage s) const { return memory[static_cast<size_t>(s)]; }
+    MemoryUsage& stageMemory(Stage s) { return memory[static_cast<size_t>(s)]; }
+
+    const LatencyHistogram& placementLatency(Stage s, size_t vertexBucket) const { return latency[static_cast<size_t>(s)][vertexBucket]; }
+    LatencyHistogram& placementLatency(Stage s, size_t vertexBucket) { return latency[static_cast<size_t>(s)][vertexBucket]; }
+
+    /**
+     * @brief Sum of the counters of all stages.
+     */
+    Counters total() const;
+
+    /**
+     * @brief Memory usage over the whole life of the bin: peaks are the maximum over all stages
+     * and the current bytes are the bytes held now.
+     */
+    MemoryUsage memoryTotal() const;
+};
+
+/**
+ * @brief Statistics of a whole pack run: one entry per bin plus aggregates.
+ */
+struct PackStats {
+    std::vector<BinStats> bins;
+
+    /**
+     * @brief Counters of each stage summed over all bins.
+     */
+    std::array<Counters, STAGE_COUNT> stageTotals() const;
+
+    /**
+     * @brief Counters summed over all stages and bins.
+     */
+    Counters total() const;
+
+    /**
+     * @brief Memory usage of each stage summed over all bins.
+     */
+    std::array<MemoryUsage, STAGE_COUNT> stageMemoryTotals() const;
+
+    /**
+     * @brief Memory usage of the whole run: the bins' lifetime usage, summed.
+     * The peak is an upper bound for the bins of a single job, since they are all alive when pack returns.
+     */
+    MemoryUsage memoryTotal() const;
+
+    /**
+     * @brief Placement latency of each stage and vertex bucket, merged over all bins.
+     */
+    std::array<LatencyByVertices, STAGE_COUNT> stageLatencyTotals() const;
+
+    /**
+     * @brief Formats the statistics as text tables: counters and memory per stage and per bin,
+     * then placement latency percentiles per stage and vertex bucket.
+     */
+    std::string report() const;
+};
+
+} // namespace Stats
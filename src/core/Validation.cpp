@@ -0,0 +1,158 @@
+#include "Validation.h"
+#include <boost/geometry/algorithms/area.hpp>
+#include <boost/geometry/algorithms/convert.hpp>
+#include <boost/geometry/algorithms/envelope.hpp>
+#include <boost/geometry/algorithms/intersection.hpp>
+#include <boost/geometry/algorithms/intersects.hpp>
+#include <boost/geometry/algorithms/within.hpp>
+#include <boost/geometry/algorithms/touches.hpp>
+#include <boost/geometry/io/wkt/wkt.hpp>
+#include <cmath>
+#include <mutex>
+#include <sstream>
+
+namespace Validation {
+
+namespace detail {
+    std::atomic<bool> enabled{false};
+}
+
+namespace {
+    std::mutex sessionMutex;
+    Options sessionOptions;
+    Report sessionReport;
+    uint64_t rejectedSeen = 0;
+
+    template <typename Geometry>
+    std::string toWkt(const Geometry& geometry) {
+        std::ostringstream out;
+        out.precision(17);
+        out << bg::wkt(geometry);
+        return out.str();
+    }
+
+    // Called with sessionMutex held.
+    void record(Kind kind, Stats::Stage stage, std::string detail, const MArea& piece, std::string otherWkt) {
+        sessionReport.disagreementCount++;
+        if (sessionReport.disagreements.size() < sessionOptions.maxRecorded) {
+            sessionReport.disagreements.push_back({kind, stage, std::move(detail), toWkt(piece.getShape()), std::move(otherWkt)});
+        }
+    }
+
+    // Deterministic sampling: exactly floor(n * rate) of the first n rejected placements are checked.
+    bool sampleRejected() {
+        double rate = sessionOptions.rejectedSampleRate;
+        uint64_t n = rejectedSeen++;
+        return std::floor((n + 1) * rate) > std::floor(n * rate);
+    }
+
+    bool sameBox(const Rectangle2D& a, const Rectangle2D& b) {
+        return a.min_corner().x() == b.min_corner().x() && a.min_corner().y() == b.min_corner().y() &&
+               a.max_corner().x() == b.max_corner().x() && a.max_corner().y() == b.max_corner().y();
+    }
+}
+
+const char* kindName(Kind kind) {
+    switch (kind) {
+        case Kind::AcceptedButCollides: return "accepted but collides";
+        case Kind::AcceptedOutsideBin: return "accepted outside the bin";
+        case Kind::RejectedButFree: return "rejected but free";
+        case Kind::StaleGeometry: return "stale cached geometry";
+    }
+    return "unknown";
+}
+
+std::string Report::format() const {
+    std::ostringstream out;
+    out << "Validation: " << acceptedChecked << " accepted and " << rejectedChecked << " rejected placements re-checked, "
+        << disagreementCount << " disagreement(s).\n";
+    for (size_t i = 0; i < disagreements.size(); ++i) {
+        const Disagreement& d = disagreements[i];
+        out << "#" << (i + 1) << " " << kindName(d.kind) << " in " << Stats::stageName(d.stage) << ": " << d.detail << "\n";
+        out << "  piece: " << d.pieceWkt << "\n";
+        if (!d.otherWkt.empty()) {
+            out << "  other: " << d.otherWkt << "\n";
+        }
+    }
+    if (disagreementCount > disagreements.size()) {
+        out << "(" << (disagreementCount - disagreements.size()) << " more not recorded)\n";
+    }
+    return out.str();
+}
+
+void start(const Options& options) {
+    std::lock_guard<std::mutex> lock(sessionMutex);
+    sessionOptions = options;
+    sessionReport = Report();
+    rejectedSeen = 0;
+    detail::enabled.store(true, std::memory_order_relaxed);
+}
+
+Report stop() {
+    std::lock_guard<std::mutex> lock(sessionMutex);
+    detail::enabled.store(false, std::memory_order_relaxed);
+    Report report = std::move(sessionReport);
+    sessionReport = Report();
+    return report;
+}
+
+void checkCollision(const MArea& piece, const std::vector<MArea>& placedPieces, std::optional<size_t> ignoredPieceIndex,
+                    const Rectangle2D& binDimension, bool collides, Stats::Stage stage) {
+    std::lock_guard<std::mutex> lock(sessionMutex);
+    if (!detail::enabled.load(std::memory_order_relaxed)) {
+        return;
+    }
+    if (collides && !sampleRejected()) {
+        return;
+    }
+    (collides ? sessionReport.rejectedChecked : sessionReport.acceptedChecked)++;
+
+    // Reference verdict: brute force over every placed piece, straight on the polygons.
+    // Pieces that only touch collide by the rule of the bins, but the broad phase tests boxes exactly
+    // while bg::intersects compares with a tolerance, so a contact within rounding may be reported
+    // free. An accepted placement is therefore only a disagreement if its interior overlaps a piece.
+    std::optional<size_t> hit;
+    for (size_t i = 0; i < placedPieces.size() && !hit; ++i) {
+        const MArea& other = placedPieces[i];
+        if ((ignoredPieceIndex && i == *ignoredPieceIndex) || &other == &piece || piece.isEmpty() || other.isEmpty()) {
+            continue;
+        }
+        if (bg::intersects(piece.getShape(), other.getShape()) && (collides || !bg::touches(piece.getShape(), other.getShape()))) {
+            hit = i;
+        }
+    }
+
+    if (collides) {
+        if (!hit) {
+            record(Kind::RejectedButFree, stage, "no placed piece intersects it", piece, "");
+        }
+        return;
+    }
+
+    if (hit) {
+        std::ostringstream detail;
+        MultiPolygon overlap;
+        bg::intersection(piece.getShape(), placedPieces[*hit].getShape(), overlap);
+        detail << "overlaps placed piece #" << *hit << " (id " << placedPieces[*hit].getID() << "), overlap area " << bg::area(overlap);
+        record(Kind::AcceptedButCollides, stage, detail.str(), piece, toWkt(placedPieces[*hit].getShape()));
+    }
+
+    if (!piece.isEmpty()) {
+        Polygon bin;
+        bg::convert(binDimension, bin);
+        if (!bg::within(piece.getShape(), bin)) {
+            record(Kind::AcceptedOutsideBin, stage, "not within the bin", piece, toWkt(bin));
+        }
+
+        double area = bg::area(piece.getShape());
+        Rectangle2D envelope;
+        bg::envelope(piece.getShape(), envelope);
+        if (std::abs(area - piece.getArea()) > 1e-9 * std::max(1.0, std::abs(area)) || !sameBox(envelope, piece.getBoundingBox2D())) {
+            std::ostringstream detail;
+            detail << "cached area " << piece.getArea() << " vs " << area;
+            record(Kind::StaleGeometry, stage, detail.str(), piece, toWkt(envelope));
+        }
+    }
+}
+
+} // namespace Validation
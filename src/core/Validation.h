@@ -0,0 +1,100 @@
+#pragma once
+
+#include "core/Stats.h"
+#include "primitives/MArea.h"
+#include "primitives/Rectangle.h"
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Differential validation of the collision verdicts of the bins.
+ *
+ * While a validation session is running, every placement accepted by Bin::isCollision is
+ * re-checked against all placed pieces with the reference bg::intersects and bg::within
+ * predicates (no spatial index, no cached geometry), and a sampled fraction of the rejected
+ * placements is re-checked as well. Disagreements are recorded with a WKT dump of the
+ * geometry involved. When the library is built without PACKING_ENABLE_VALIDATION the bins
+ * do not call into this module; otherwise a check costs a single relaxed atomic load while
+ * no session is running.
+ */
+namespace Validation {
+
+namespace detail {
+    extern std::atomic<bool> enabled;
+}
+
+/**
+ * @brief Whether a validation session is running.
+ */
+inline bool isEnabled() {
+    return detail::enabled.load(std::memory_order_relaxed);
+}
+
+struct Options {
+    double rejectedSampleRate = 0.1; // Fraction of the rejected placements re-checked, in [0, 1].
+    size_t maxRecorded = 20;         // Disagreements kept with their geometry; the rest are only counted.
+};
+
+enum class Kind {
+    AcceptedButCollides,   // Reported free, but its interior overlaps a placed piece.
+    AcceptedOutsideBin,    // Reported free, but not within the bin.
+    RejectedButFree,       // Reported colliding, but intersects no placed piece.
+    StaleGeometry          // Cached area or bounding box differs from the geometry.
+};
+
+const char* kindName(Kind kind);
+
+struct Disagreement {
+    Kind kind;
+    Stats::Stage stage;
+    std::string detail;
+    std::string pieceWkt;
+    std::string otherWkt; // The placed piece or bin involved, if any.
+};
+
+struct Report {
+    uint64_t acceptedChecked = 0;
+    uint64_t rejectedChecked = 0;
+    uint64_t disagreementCount = 0;
+    std::vector<Disagreement> disagreements; // The first Options::maxRecorded ones.
+
+    bool ok() const { return disagreementCount == 0; }
+
+    /**
+     * @brief Summary line followed by every recorded disagreement with its WKT dump.
+     */
+    std::string format() const;
+};
+
+/**
+ * @brief Starts a validation session, discarding the results of a previous one.
+ */
+void start(const Options& options = Options());
+
+/**
+ * @brief Stops the session and returns what it found; a later stop() without start() returns an empty report.
+ * Must be called once all validated work has finished.
+ */
+Report stop();
+
+/**
+ * @brief Re-checks a collision verdict of a bin with the reference predicates.
+ * @param piece The piece that was tested.
+ * @param placedPieces The pieces of the bin.
+ * @param ignoredPieceIndex Index of a placed piece excluded from the test, if any. A placed
+ *        piece that is the tested piece itself (same object) is always excluded.
+ * @param binDimension The bin the piece must be within.
+ * @param collides The verdict of the bin.
+ * @param stage The stage the verdict was made in.
+ */
+void checkCollision(const MArea& piece, const std::vector<MArea>& placedPieces, std::optional<size_t> ignoredPieceIndex,
+                    const Rectangle2D& binDimension, bool collides, Stats::Stage stage);
+
+} // namespace Validation
+
+#ifndef PACKING_ENABLE_VALIDATION
+#define PACKING_ENABLE_VALIDATION 0
+#endif
@@ -1,12 +1,20 @@
 #include "core/Bin.h"
 #include "core/BinPacking.h"
+#include "core/Validation.h"
 #include "utils/Utils.h"
+#include "utils/Trace.h"
 #include <iostream>
 #include <fstream>
 #include <string>
 #include <vector>
 #include <algorithm>
 #include <chrono>
+#include <condition_variable>
+#include <iomanip>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <thread>
 
 // Forward declaration for helper functions
 void createOutputFiles(const std::vector<Bin>& bins);
@@ -22,6 +30,15 @@ int main(int argc, char* argv[]) {
     std::vector<std::string> args(argv + 1, argv + argc);
     bool useParallel = false;
     bool extendedOutput = false;
+    bool printStats = false;
+    bool printProgress = false;
+    double timeLimitSeconds = 0.0;
+    bool validate = false;
+    Validation::Options validationOptions;
+    std::string configFileName;
+    double fixedPointScale = 0;
+    std::optional<BroadPhase> broadPhase;
+    std::string traceFileName;
     std::string fileName;
 
     for (const auto& arg : args) {
@@ -29,6 +46,31 @@ int main(int argc, char* argv[]) {
             useParallel = true;
         } else if (arg == "-x") {
             extendedOutput = true;
+        } else if (arg == "--stats") {
+            printStats = true;
+        } else if (arg == "--progress") {
+            printProgress = true;
+        } else if (arg.rfind("--time-limit=", 0) == 0) {
+            timeLimitSeconds = std::stod(arg.substr(std::string("--time-limit=").size()));
+        } else if (arg == "--validate") {
+            validate = true;
+        } else if (arg.rfind("--validate=", 0) == 0) {
+            validate = true;
+            validationOptions.rejectedSampleRate = std::stod(arg.substr(std::string("--validate=").size()));
+        } else if (arg.rfind("--config=", 0) == 0) {
+            configFileName = arg.substr(std::string("--config=").size());
+        } else if (arg.rfind("--fixed-point=", 0) == 0) {
+            fixedPointScale = std::stod(arg.substr(std::string("--fixed-point=").size()));
+        } else if (arg.rfind("--broad-phase=", 0) == 0) {
+            std::string name = arg.substr(std::string("--broad-phase=").size());
+            broadPhase = parseBroadPhase(name);
+            if (!broadPhase) {
+                std::cerr << "Error: Unknown broad phase '" << name << "'." << std::endl;
+                printUsage();
+                return 1;
+            }
+        } else if (arg.rfind("--trace=", 0) == 0) {
+            traceFileName = arg.substr(std::string("--trace=").size());
         } else {
             fileName = arg;
         }
@@ -57,15 +99,106 @@ int main(int argc, char* argv[]) {
         std::cout << "Running in SEQUENTIAL mode." << std::endl;
     }
 
+    if (!traceFileName.empty()) {
+        Trace::start();
+    }
+    if (validate) {
+#if PACKING_ENABLE_VALIDATION
+        Validation::start(validationOptions);
+#else
+        std::cerr << "Warning: --validate ignored, the library was built without PACKING_ENABLE_VALIDATION." << std::endl;
+        validate = false;
+#endif
+    }
+
+    BinPacking::PackOptions options;
+    options.useParallel = useParallel;
+    if (!configFileName.empty()) {
+        auto config = PackingConfig::load(configFileName);
+        if (!config) {
+            std::cerr << "Failed to load config file." << std::endl;
+            return 1;
+        }
+        options.config = *config;
+        std::cout << "Step factors: " << options.config.toString() << std::endl;
+    }
+    if (fixedPointScale > 0) {
+        options.config.fixedPointScale = fixedPointScale;
+        std::cout << "Fixed-point grid: 1/" << fixedPointScale << " units" << std::endl;
+    }
+    if (broadPhase) {
+        options.config.broadPhase = *broadPhase;
+        std::cout << "Broad phase: " << broadPhaseName(*broadPhase) << std::endl;
+    }
+    Progress::CancellationToken cancellation;
+    options.cancellation = &cancellation;
+    if (printProgress) {
+        options.onProgress = [](const Progress::Report& r) {
+            std::ostringstream line;
+            line << std::fixed << std::setprecision(1) << "[" << r.elapsedSeconds << "s] "
+                 << r.piecesPlaced << "/" << r.piecesTotal << " pieces, " << r.binsOpened << " bins, ";
+            if (r.finished) {
+                line << (r.cancelled ? "cancelled" : "finished");
+            } else {
+                line << Stats::stageName(r.stage);
+                if (r.etaSeconds >= 0) {
+                    line << ", ETA " << r.etaSeconds << "s";
+                }
+            }
+            std::cerr << line.str() << std::endl;
+        };
+    }
+
+    // The time limit is enforced from a watchdog thread through the cancellation token.
+    std::mutex watchdogMutex;
+    std::condition_variable watchdogWakeup;
+    bool packingDone = false;
+    std::thread watchdog;
+    if (timeLimitSeconds > 0) {
+        watchdog = std::thread([&]() {
+            std::unique_lock<std::mutex> lock(watchdogMutex);
+            if (!watchdogWakeup.wait_for(lock, std::chrono::duration<double>(timeLimitSeconds), [&] { return packingDone; })) {
+                cancellation.cancel();
+            }
+        });
+    }
+
     std::cout << "Starting packing process..." << std::endl;
     auto startTime = std::chrono::high_resolution_clock::now();
-    std::vector<Bin> bins = BinPacking::pack(loadResult->pieces, loadResult->binDimension, useParallel);
+    std::vector<Bin> bins = BinPacking::pack(loadResult->pieces, loadResult->binDimension, options);
     auto endTime = std::chrono::high_resolution_clock::now();
+
+    if (watchdog.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(watchdogMutex);
+            packingDone = true;
+        }
+        watchdogWakeup.notify_one();
+        watchdog.join();
+    }
+    if (cancellation.isCancelled()) {
+        std::cerr << "Warning: Time limit of " << timeLimitSeconds << " seconds reached; the result is incomplete." << std::endl;
+    }
+
+    if (!traceFileName.empty() && Trace::stop(traceFileName)) {
+        std::cout << "Trace written to " << traceFileName << std::endl;
+    }
     std::chrono::duration<double> elapsed = endTime - startTime;
 
     std::cout << "Packing process finished. " << bins.size() << " bins used." << std::endl;
     std::cout << "Elapsed time: " << elapsed.count() << " seconds." << std::endl;
 
+    if (printStats) {
+        std::cout << BinPacking::collectStats(bins).report();
+    }
+
+    bool validationOk = true;
+    if (validate) {
+        Validation::Report report = Validation::stop();
+        validationOk = report.ok();
+        (validationOk ? std::cout : std::cerr) << report.format();
+    }
+
     if (extendedOutput) {
         std::cout << "Generating extended output file..." << std::endl;
         createExtendedOutputFile(bins);
@@ -76,7 +209,7 @@ int main(int argc, char* argv[]) {
 
     std::cout << "DONE!!!" << std::endl;
 
-    return 0;
+    return validationOk ? 0 : 3;
 }
 
 void createOutputFiles(const std::vector<Bin>& bins) {
@@ -127,10 +260,21 @@ void printUsage() {
     std::cout << std::endl;
     std::cout << "Usage:" << std::endl;
     std::cout << std::endl;
-    std::cout << "$ ./packing_main [--parallel] [-x] <file name>" << std::endl;
+    std::cout << "$ ./packing_main [--parallel] [-x] [--stats] [--progress] [--time-limit=<seconds>] [--validate[=<rate>]] [--config=<config file>] [--fixed-point=<scale>] [--broad-phase=<name>] [--trace=<trace file>] <file name>" << std::endl;
     
     std::cout << "  --parallel : (Optional) Run the packing algorithm using a parallel implementation." << std::endl;
     std::cout << "  -x         : (Optional) Generate a single 'posiciones.txt' output file instead of one file per bin." << std::endl;
+    std::cout << "  --stats    : (Optional) Print the hot-path counters and peak memory of the run, per stage and per bin." << std::endl;
+    std::cout << "  --progress : (Optional) Print the progress of the run (pieces placed, bins, stage and ETA) to stderr." << std::endl;
+    std::cout << "  --time-limit=<seconds>: (Optional) Cancel the run after this time and write the bins packed so far." << std::endl;
+    std::cout << "  --validate[=<rate>]: (Optional) Re-check every accepted placement, and this fraction (default 0.1) of the rejected ones, with the" << std::endl;
+    std::cout << "               reference Boost.Geometry predicates; print the disagreements and exit with status 3 if there are any." << std::endl;
+    std::cout << "  --config=<config file>: (Optional) Step factors of dive and sweep, e.g. as written by packing_autotune." << std::endl;
+    std::cout << "  --fixed-point=<scale>: (Optional) Round the geometry to a grid of 1/scale file units and test collisions exactly on it," << std::endl;
+    std::cout << "               e.g. 1000 for a precision of 0.001 (overrides fixed_point_scale of the config file)." << std::endl;
+    std::cout << "  --broad-phase=<name>: (Optional) Structure of the collision broad phase: auto (default), scan, grid, hash, rtree-linear," << std::endl;
+    std::cout << "               rtree-quadratic or rtree-rstar. It does not change the packing (overrides broad_phase of the config file)." << std::endl;
+    std::cout << "  --trace=<trace file>: (Optional) Write a Chrome trace-event JSON timeline of the packing stages (open it in Perfetto)." << std::endl;
     std::cout << "  <file name>: file describing pieces (see file structure specifications below)." << std::endl;
     std::cout << std::endl;
     std::cout << "The input pieces file should be structured as follows: " << std::endl;
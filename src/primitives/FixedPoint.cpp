@@ -0,0 +1,184 @@
+#include "FixedPoint.h"
+#include <algorithm>
+#include <boost/container/small_vector.hpp>
+
+namespace FixedPoint {
+
+namespace {
+    struct Box {
+        int64_t minX, minY, maxX, maxY;
+
+        bool overlaps(const Box& other) const {
+            return minX <= other.maxX && other.minX <= maxX && minY <= other.maxY && other.minY <= maxY;
+        }
+    };
+
+    struct Edge {
+        Point a, b;
+        Box box;
+    };
+
+    using Edges = boost::container::small_vector<Edge, 64>;
+
+    Box toFixed(const Rectangle2D& r, double scale) {
+        return {FixedPoint::toFixed(r.min_corner().x(), scale), FixedPoint::toFixed(r.min_corner().y(), scale),
+                FixedPoint::toFixed(r.max_corner().x(), scale), FixedPoint::toFixed(r.max_corner().y(), scale)};
+    }
+
+    Point toFixed(const MPointDouble& p, double scale) {
+        return {FixedPoint::toFixed(p.x(), scale), FixedPoint::toFixed(p.y(), scale)};
+    }
+
+    // Edges of every ring of the piece whose box meets the window, sorted by the left end of their box.
+    void collectEdges(const MArea& piece, double scale, const Box& window, Edges& edges) {
+        for (const auto& polygon : piece.view()) {
+            auto addRing = [&](const ShapeView::RingSpan& ring) {
+                if (ring.size() < 2) {
+                    return;
+                }
+                Point previous = toFixed(ring[0], scale);
+                for (size_t i = 1; i < ring.size(); ++i) {
+                    Point current = toFixed(ring[i], scale);
+                    Box box{std::min(previous.x, current.x), std::min(previous.y, current.y),
+                            std::max(previous.x, current.x), std::max(previous.y, current.y)};
+                    if (box.overlaps(window)) {
+                        edges.push_back({previous, current, box});
+                    }
+                    previous = current;
+                }
+            };
+            addRing(polygon.outer);
+            for (const auto& inner : polygon.inners) {
+                addRing(inner);
+            }
+        }
+        std::sort(edges.begin(), edges.end(), [](const Edge& e, const Edge& f) { return e.box.minX < f.box.minX; });
+    }
+
+    // Sweep over x: each edge is tested against the edges of the other piece whose box spans its left end.
+    bool anyEdgesIntersect(const Edges& edgesA, const Edges& edgesB) {
+        boost::container::small_vector<const Edge*, 32> activeA, activeB;
+        auto test = [](const Edge& e, boost::container::small_vector<const Edge*, 32>& active) {
+            size_t kept = 0;
+            for (const Edge* f : active) {
+                if (f->box.maxX < e.box.minX) {
+                    continue; // Left behind by the sweep for good.
+                }
+                active[kept++] = f;
+                if (e.box.overlaps(f->box) && segmentsIntersect(e.a, e.b, f->a, f->b)) {
+                    return true;
+                }
+            }
+            active.resize(kept);
+            return false;
+        };
+        size_t i = 0, j = 0;
+        while (i < edgesA.size() || j < edgesB.size()) {
+            if (j == edgesB.size() || (i < edgesA.size() && edgesA[i].box.minX <= edgesB[j].box.minX)) {
+                if (test(edgesA[i], activeB)) {
+                    return true;
+                }
+                activeA.push_back(&edgesA[i++]);
+            } else {
+                if (test(edgesB[j], activeA)) {
+                    return true;
+                }
+                activeB.push_back(&edgesB[j++]);
+            }
+        }
+        return false;
+    }
+
+    // Even-odd rule over the rings of one polygon. The point must not lie on a ring.
+    bool insidePolygon(const Point& p, const ShapeView::PolygonView& polygon, double scale) {
+        bool inside = false;
+        auto crossRing = [&](const ShapeView::RingSpan& ring) {
+            if (ring.size() < 2) {
+                return;
+            }
+            Point u = toFixed(ring[0], scale);
+            for (size_t i = 1; i < ring.size(); ++i) {
+                Point v = toFixed(ring[i], scale);
+                if ((u.y > p.y) != (v.y > p.y)) {
+                    // The edge crosses the horizontal line through p; count it if it does so right of p.
+                    int side = orientation(u, v, p);
+                    if (v.y > u.y ? side > 0 : side < 0) {
+                        inside = !inside;
+                    }
+                }
+                u = v;
+            }
+        };
+        crossRing(polygon.outer);
+        for (const auto& inner : polygon.inners) {
+            crossRing(inner);
+        }
+        return inside;
+    }
+
+    bool insidePiece(const Point& p, const MArea& piece, double scale) {
+        for (const auto& polygon : piece.view()) {
+            if (insidePolygon(p, polygon, scale)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // With no crossing edges, every polygon of a lies either inside b or outside it entirely.
+    bool anyPolygonInside(const MArea& a, const MArea& b, double scale) {
+        for (const auto& polygon : a.view()) {
+            if (!polygon.outer.empty() && insidePiece(toFixed(polygon.outer[0], scale), b, scale)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool contains(const Box& outer, const Box& inner) {
+        return outer.minX <= inner.minX && inner.maxX <= outer.maxX && outer.minY <= inner.minY && inner.maxY <= outer.maxY;
+    }
+}
+
+bool segmentsIntersect(const Point& a, const Point& b, const Point& c, const Point& d) {
+    int o1 = orientation(a, b, c);
+    int o2 = orientation(a, b, d);
+    int o3 = orientation(c, d, a);
+    int o4 = orientation(c, d, b);
+    if (o1 != o2 && o3 != o4) {
+        return true;
+    }
+    // Collinear cases: an endpoint lying on the other segment. Its box is enough once collinear.
+    auto onSegment = [](const Point& p, const Point& q, const Point& r) {
+        return std::min(p.x, q.x) <= r.x && r.x <= std::max(p.x, q.x) && std::min(p.y, q.y) <= r.y && r.y <= std::max(p.y, q.y);
+    };
+    return (o1 == 0 && onSegment(a, b, c)) || (o2 == 0 && onSegment(a, b, d)) ||
+           (o3 == 0 && onSegment(c, d, a)) || (o4 == 0 && onSegment(c, d, b));
+}
+
+bool intersects(const MArea& a, const MArea& b, double scale) {
+    if (a.isEmpty() || b.isEmpty()) {
+        return false;
+    }
+    Box boxA = toFixed(a.getBoundingBox2D(), scale);
+    Box boxB = toFixed(b.getBoundingBox2D(), scale);
+    if (!boxA.overlaps(boxB)) {
+        return false;
+    }
+    if (a.isRectangle() && b.isRectangle()) {
+        return true;
+    }
+    Box window{std::max(boxA.minX, boxB.minX), std::max(boxA.minY, boxB.minY),
+               std::min(boxA.maxX, boxB.maxX), std::min(boxA.maxY, boxB.maxY)};
+
+    Edges edgesA, edgesB;
+    collectEdges(a, scale, window, edgesA);
+    collectEdges(b, scale, window, edgesB);
+    if (anyEdgesIntersect(edgesA, edgesB)) {
+        return true;
+    }
+    // A piece can only lie inside the other if its box does.
+    return (contains(boxB, boxA) && anyPolygonInside(a, b, scale)) || (contains(boxA, boxB) && anyPolygonInside(b, a, scale));
+}
+
+} // namespace FixedPoint
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "MArea.h"
+#include <cmath>
+#include <cstdint>
+
+/**
+ * @brief Exact geometric predicates on an integer grid.
+ *
+ * In fixed-point mode (PackingConfig::fixedPointScale) every coordinate is a multiple of
+ * 1 / scale file units, stored as the int64 count of grid units. Orientation is the sign of
+ * an exact 128-bit cross product, so intersection tests need no tolerance: two pieces
+ * collide if and only if their snapped geometries share a point, touching included.
+ * Coordinates must stay below MAX_COORDINATE grid units in magnitude.
+ */
+namespace FixedPoint {
+
+constexpr int64_t MAX_COORDINATE = int64_t(1) << 52;
+
+struct Point {
+    int64_t x;
+    int64_t y;
+};
+
+/**
+ * @brief Grid units of a coordinate given in file units.
+ */
+inline int64_t toFixed(double value, double scale) {
+    return static_cast<int64_t>(std::floor(value * scale + 0.5)); // Inlined, unlike std::llround.
+}
+
+/**
+ * @brief The double closest to a coordinate rounded to the grid.
+ */
+inline double snap(double value, double scale) {
+    return static_cast<double>(toFixed(value, scale)) / scale;
+}
+
+/**
+ * @brief Sign of the turn a -> b -> c: 1 counterclockwise, -1 clockwise, 0 collinear.
+ */
+inline int orientation(const Point& a, const Point& b, const Point& c) {
+    __int128 cross = static_cast<__int128>(b.x - a.x) * (c.y - a.y) - static_cast<__int128>(b.y - a.y) * (c.x - a.x);
+    return (cross > 0) - (cross < 0);
+}
+
+/**
+ * @brief Whether the closed segments ab and cd share a point.
+ */
+bool segmentsIntersect(const Point& a, const Point& b, const Point& c, const Point& d);
+
+/**
+ * @brief Whether two pieces share a point once their vertices are rounded to the grid.
+ * Only the edges inside the overlap of the two boxes are tested, pairwise along a sweep in x.
+ * If no edges meet, one piece may still lie inside the other, which a point-in-polygon test
+ * decides when the boxes allow it.
+ */
+bool intersects(const MArea& a, const MArea& b, double scale);
+
+} // namespace FixedPoint
@@ -1,4 +1,5 @@
 #include "MArea.h"
+#include "FixedPoint.h"
 #include <boost/geometry/algorithms/transform.hpp>
 #include <boost/geometry/strategies/transform/matrix_transformers.hpp>
 #include <boost/geometry/algorithms/envelope.hpp>
@@ -9,27 +10,101 @@
 #include <boost/geometry/algorithms/difference.hpp>
 #include <boost/geometry/algorithms/intersection.hpp>
 #include <boost/math/constants/constants.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
 
 namespace bg = boost::geometry;
 namespace bgt = boost::geometry::strategy::transform;
 
-MArea::MArea() : id(0), rotation(0.0), area(0.0) {}
+namespace {
+    // Smallest distance a vertex of from travels along y, down for direction 1 and up for -1,
+    // before it reaches an edge of to; infinity if no edge lies that way. Two polygons moving
+    // apart along y first touch at a vertex of one on an edge of the other.
+    double verticalGap(const MArea& from, const MArea& to, double direction) {
+        const Rectangle2D fromBox = from.getBoundingBox2D();
+        const double minX = fromBox.min_corner().x(), maxX = fromBox.max_corner().x();
+        const ShapeView::RingSpan points = from.vertices();
+        double gap = std::numeric_limits<double>::infinity();
+        auto edgesOf = [&](const ShapeView::RingSpan& ring) {
+            for (size_t i = 0; i + 1 < ring.size(); ++i) {
+                const MPointDouble& a = ring[i];
+                const MPointDouble& b = ring[i + 1];
+                const double x0 = std::min(a.x(), b.x()), x1 = std::max(a.x(), b.x());
+                if (x1 < minX || x0 > maxX) {
+                    continue;
+                }
+                for (const MPointDouble& v : points) {
+                    if (v.x() < x0 || v.x() > x1) {
+                        continue;
+                    }
+                    // A vertical edge is met at its end nearest the vertex, or at once if beside it.
+                    double y = x0 == x1 ? std::clamp(v.y(), std::min(a.y(), b.y()), std::max(a.y(), b.y()))
+                                        : a.y() + (b.y() - a.y()) * (v.x() - a.x()) / (b.x() - a.x());
+                    double d = direction * (v.y() - y);
+                    if (d >= 0 && d < gap) {
+                        gap = d;
+                    }
+                }
+            }
+        };
+        for (const auto& polygon : to.view()) {
+            edgesOf(polygon.outer);
+            for (const auto& inner : polygon.inners) {
+                edgesOf(inner);
+            }
+        }
+        return gap;
+    }
+}
+
+MArea::MArea() : bbox(MPointDouble(0, 0), MPointDouble(0, 0)), rectangle(false), id(0), rotation(0.0), area(0.0) {}
 
-MArea::MArea(const std::vector<MPointDouble>& points, int id) : id(id), rotation(0.0) {
+MArea::MArea(const std::vector<MPointDouble>& points, int id) : MArea() {
+    this->id = id;
     if (points.empty()) {
-        area = 0.0;
         return;
     }
     Polygon poly;
     bg::assign_points(poly, points);
     bg::correct(poly); // Ensure correct winding order
-    shape.push_back(poly);
-    updateArea();
+    assign(MultiPolygon{poly});
 }
 
-MArea::MArea(const MArea& outer, const MArea& inner) : id(outer.id), rotation(0.0) {
-    bg::difference(outer.shape, inner.shape, this->shape);
+MArea::MArea(const double* xy, size_t vertexCount, int id) : MArea() {
+    this->id = id;
+    if (vertexCount == 0) {
+        return;
+    }
+    vertexBuffer.reserve(vertexCount + 1); // Room for the closing point.
+    for (size_t i = 0; i < vertexCount; ++i) {
+        vertexBuffer.emplace_back(xy[2 * i], xy[2 * i + 1]);
+    }
+    // What bg::correct does to the outer ring: close it, then make it clockwise.
+    if (vertexBuffer.size() > 2 && bg::disjoint(vertexBuffer.front(), vertexBuffer.back())) {
+        vertexBuffer.push_back(vertexBuffer.front());
+    }
+    if (bg::area(vertices()) < 0) {
+        std::reverse(vertexBuffer.begin(), vertexBuffer.end());
+    }
+    ringEnds.push_back(static_cast<uint32_t>(vertexBuffer.size()));
+    polygonRingEnds.push_back(1);
+    updateBoundingBox();
     updateArea();
+    detectRectangle();
+}
+
+MArea::MArea(const MArea& outer, const MArea& inner) : MArea() {
+    this->id = outer.id;
+    MultiPolygon result;
+    bg::difference(outer.view(), inner.view(), result);
+    assign(result);
+}
+
+MArea::MArea(MultiPolygon shape, int id, double rotation) : MArea() {
+    this->id = id;
+    this->rotation = rotation;
+    assign(shape);
 }
 
 int MArea::getID() const { return id; }
@@ -38,90 +113,204 @@ double MArea::getArea() const { return area; }
 
 double MArea::getRotation() const { return rotation; }
 
+void MArea::assign(const MultiPolygon& shape) {
+    size_t nVertices = 0;
+    size_t nRings = 0;
+    for (const auto& poly : shape) {
+        nVertices += bg::num_points(poly);
+        nRings += 1 + poly.inners().size();
+    }
+    vertexBuffer.clear();
+    vertexBuffer.reserve(nVertices);
+    ringEnds.clear();
+    ringEnds.reserve(nRings);
+    polygonRingEnds.clear();
+    polygonRingEnds.reserve(shape.size());
+    auto appendRing = [this](const Polygon::ring_type& ring) {
+        vertexBuffer.insert(vertexBuffer.end(), ring.begin(), ring.end());
+        ringEnds.push_back(static_cast<uint32_t>(vertexBuffer.size()));
+    };
+    for (const auto& poly : shape) {
+        appendRing(poly.outer());
+        for (const auto& inner : poly.inners()) {
+            appendRing(inner);
+        }
+        polygonRingEnds.push_back(static_cast<uint32_t>(ringEnds.size()));
+    }
+    updateBoundingBox();
+    updateArea();
+    detectRectangle();
+}
+
+void MArea::detectRectangle() {
+    // One closed ring of four edges that alternate between horizontal and vertical.
+    rectangle = false;
+    if (ringEnds.size() != 1 || vertexBuffer.size() != 5) {
+        return;
+    }
+    const auto& v = vertexBuffer;
+    if (v[4].x() != v[0].x() || v[4].y() != v[0].y()) {
+        return;
+    }
+    bool firstHorizontal = v[0].y() == v[1].y();
+    for (size_t i = 0; i < 4; ++i) {
+        bool horizontal = v[i].y() == v[i + 1].y() && v[i].x() != v[i + 1].x();
+        bool vertical = v[i].x() == v[i + 1].x() && v[i].y() != v[i + 1].y();
+        bool expectHorizontal = (i % 2 == 0) == firstHorizontal;
+        if (expectHorizontal ? !horizontal : !vertical) {
+            return;
+        }
+    }
+    rectangle = true;
+}
+
+void MArea::updateBoundingBox() {
+    if (isEmpty()) {
+        bbox = Rectangle2D(MPointDouble(0, 0), MPointDouble(0, 0));
+    } else {
+        bg::envelope(view(), bbox);
+    }
+}
+
 void MArea::updateArea() {
-    this->area = bg::area(shape);
+    this->area = isEmpty() ? 0.0 : bg::area(view());
 }
 
 Rectangle2D MArea::getBoundingBox2D() const {
-    Rectangle2D box;
-    if (!isEmpty()) {
-        bg::envelope(shape, box);
-    }
-    return box;
+    return bbox;
 }
 
 double MArea::getFreeArea() const {
     if (isEmpty()) {
         return 0.0;
     }
-    Rectangle2D bbox = getBoundingBox2D();
     double bboxArea = RectangleUtils::getWidth(bbox) * RectangleUtils::getHeight(bbox);
     return bboxArea - this->area;
 }
 
 size_t MArea::getVertexCount() const {
-    size_t count = 0;
-    for (const auto& poly : shape) {
-        count += bg::num_points(poly);
+    return vertexBuffer.size();
+}
+
+bool MArea::isRectangle() const {
+    return rectangle;
+}
+
+MultiPolygon MArea::getShape() const {
+    MultiPolygon shape;
+    shape.reserve(polygonRingEnds.size());
+    for (const auto& polygonView : view()) {
+        Polygon& poly = shape.emplace_back();
+        poly.outer().assign(polygonView.outer.begin(), polygonView.outer.end());
+        for (const auto& inner : polygonView.inners) {
+            poly.inners().emplace_back(inner.begin(), inner.end());
+        }
+    }
+    return shape;
+}
+
+ShapeView::MultiPolygonView MArea::view() const {
+    return ShapeView::MultiPolygonView(vertexBuffer.data(), {ringEnds.data(), ringEnds.data() + ringEnds.size()},
+                                       {polygonRingEnds.data(), polygonRingEnds.data() + polygonRingEnds.size()});
+}
+
+ShapeView::RingSpan MArea::vertices() const {
+    return {vertexBuffer.data(), vertexBuffer.data() + vertexBuffer.size()};
+}
+
+size_t MArea::getMemoryUsage() const {
+    size_t bytes = vertexBuffer.capacity() * sizeof(MPointDouble);
+    // small_vector only reaches the heap once it outgrows its inline storage.
+    if (ringEnds.capacity() > ringEnds.static_capacity) {
+        bytes += ringEnds.capacity() * sizeof(uint32_t);
     }
-    return count;
+    if (polygonRingEnds.capacity() > polygonRingEnds.static_capacity) {
+        bytes += polygonRingEnds.capacity() * sizeof(uint32_t);
+    }
+    return bytes;
 }
 
 void MArea::add(const MArea& other) {
     if (other.isEmpty()) return;
     if (this->isEmpty()) {
-        this->shape = other.shape;
+        vertexBuffer = other.vertexBuffer;
+        ringEnds = other.ringEnds;
+        polygonRingEnds = other.polygonRingEnds;
+        bbox = other.bbox;
+        area = other.area;
+        rectangle = other.rectangle;
     } else {
         MultiPolygon result;
-        bg::union_(this->shape, other.shape, result);
-        this->shape = result;
+        bg::union_(view(), other.view(), result);
+        assign(result);
     }
-    updateArea();
 }
 
 void MArea::subtract(const MArea& other) {
     if (other.isEmpty() || this->isEmpty()) return;
     MultiPolygon result;
-    bg::difference(this->shape, other.shape, result);
-    this->shape = result;
-    updateArea();
+    bg::difference(view(), other.view(), result);
+    assign(result);
 }
 
 void MArea::intersect(const MArea& other) {
-    if (this->isEmpty() || other.isEmpty()) {
-        this->shape.clear();
-    } else {
-        MultiPolygon result;
-        bg::intersection(this->shape, other.shape, result);
-        this->shape = result;
+    MultiPolygon result;
+    if (!this->isEmpty() && !other.isEmpty()) {
+        bg::intersection(view(), other.view(), result);
     }
-    updateArea();
+    assign(result);
 }
 
 bool MArea::intersection(const MArea& other) const {
     if (this->isEmpty() || other.isEmpty()) {
         return false;
     }
-    return bg::intersects(this->shape, other.shape);
+    if (!bg::intersects(bbox, other.bbox)) {
+        return false;
+    }
+    if (rectangle && other.rectangle) {
+        return true; // The boxes are the shapes.
+    }
+    return bg::intersects(view(), other.view());
+}
+
+double MArea::dropDistance(const MArea& below) const {
+    const double never = std::numeric_limits<double>::infinity();
+    if (this->isEmpty() || below.isEmpty()) {
+        return never;
+    }
+    if (bbox.max_corner().x() < below.bbox.min_corner().x() || below.bbox.max_corner().x() < bbox.min_corner().x()) {
+        return never;
+    }
+    if (rectangle && below.rectangle) {
+        double gap = bbox.min_corner().y() - below.bbox.max_corner().y();
+        return gap >= 0 ? gap : never; // Otherwise below lies above this piece.
+    }
+    return std::min(verticalGap(*this, below, 1.0), verticalGap(below, *this, -1.0));
 }
 
 bool MArea::isEmpty() const {
-    return bg::is_empty(shape);
+    return vertexBuffer.empty();
 }
 
 bool MArea::isInside(const Rectangle2D& rect) const {
     if (isEmpty()) {
         return true;
     }
-    return RectangleUtils::contains(rect, getBoundingBox2D());
+    return RectangleUtils::contains(rect, bbox);
 }
 
 void MArea::move(const MVector& vector) {
     if (isEmpty()) return;
+    // Translated in place; the transformer is the one bg::transform would apply to every point.
     bgt::translate_transformer<double, 2, 2> translate(vector.getX(), vector.getY());
-    MultiPolygon result;
-    bg::transform(shape, result, translate);
-    shape = result;
+    for (auto& p : vertexBuffer) {
+        translate.apply(MPointDouble(p), p);
+    }
+    MPointDouble minCorner, maxCorner;
+    translate.apply(bbox.min_corner(), minCorner);
+    translate.apply(bbox.max_corner(), maxCorner);
+    bbox = Rectangle2D(minCorner, maxCorner); // Rounding is monotonic, so this is the envelope of the moved points.
 }
 
 void MArea::rotate(double degrees) {
@@ -131,7 +320,11 @@ void MArea::rotate(double degrees) {
     while (this->rotation >= 360.0) this->rotation -= 360.0;
     while (this->rotation < 0.0) this->rotation += 360.0;
 
-    Rectangle2D bbox = getBoundingBox2D();
+    if (rectangle && std::fmod(degrees, 90.0) == 0.0) {
+        rotateQuarterTurns(static_cast<int>(degrees / 90.0));
+        return;
+    }
+
     MPointDouble center(
         RectangleUtils::getX(bbox) + RectangleUtils::getWidth(bbox) / 2.0,
         RectangleUtils::getY(bbox) + RectangleUtils::getHeight(bbox) / 2.0
@@ -147,19 +340,43 @@ void MArea::rotate(double degrees) {
     double radians = degrees * boost::math::constants::pi<double>() / 180.0;
     bgt::rotate_transformer<bg::radian, double, 2, 2> rotate(radians);
 
-    // Apply transformations sequentially, using separate output variables
-    // to avoid potential corruption from in-place transforms.
-    MultiPolygon translated_shape;
-    bg::transform(shape, translated_shape, to_origin);
-    MultiPolygon rotated_shape;
-    bg::transform(translated_shape, rotated_shape, rotate);
-    bg::transform(rotated_shape, shape, from_origin);
+    // The three steps are applied point by point, in place, with separate temporaries
+    // since the transformers do not support aliased input and output.
+    for (auto& p : vertexBuffer) {
+        MPointDouble translated, rotated;
+        to_origin.apply(p, translated);
+        rotate.apply(translated, rotated);
+        from_origin.apply(rotated, p);
+    }
+    updateBoundingBox();
+    rectangle = false; // Only quarter turns, handled above, keep a rectangle axis-aligned.
+}
+
+void MArea::rotateQuarterTurns(int quarterTurns) {
+    // The exact counterpart of rotate_transformer for multiples of 90 degrees (clockwise for a
+    // positive angle) about the center of the box: each corner lands exactly on another one.
+    double cx = RectangleUtils::getX(bbox) + RectangleUtils::getWidth(bbox) / 2.0;
+    double cy = RectangleUtils::getY(bbox) + RectangleUtils::getHeight(bbox) / 2.0;
+    int turns = ((quarterTurns % 4) + 4) % 4;
+    for (auto& p : vertexBuffer) {
+        double dx = p.x() - cx;
+        double dy = p.y() - cy;
+        switch (turns) {
+            case 1: p = MPointDouble(cx + dy, cy - dx); break;
+            case 2: p = MPointDouble(cx - dx, cy - dy); break;
+            case 3: p = MPointDouble(cx - dy, cy + dx); break;
+            default: break;
+        }
+    }
+    const MPointDouble& a = vertexBuffer[0];
+    const MPointDouble& b = vertexBuffer[2]; // The opposite corner.
+    bbox = Rectangle2D(MPointDouble(std::min(a.x(), b.x()), std::min(a.y(), b.y())),
+                       MPointDouble(std::max(a.x(), b.x()), std::max(a.y(), b.y())));
 }
 
 void MArea::placeInPosition(double x, double y) {
     if (isEmpty()) return;
 
-    Rectangle2D bbox = getBoundingBox2D();
     double currentX = RectangleUtils::getX(bbox);
     double currentY = RectangleUtils::getY(bbox);
 
@@ -167,6 +384,16 @@ void MArea::placeInPosition(double x, double y) {
     move(translation_vector);
 }
 
+void MArea::snapToGrid(double scale) {
+    if (isEmpty()) return;
+    for (auto& p : vertexBuffer) {
+        p = MPointDouble(FixedPoint::snap(p.x(), scale), FixedPoint::snap(p.y(), scale));
+    }
+    updateBoundingBox();
+    updateArea();
+    detectRectangle();
+}
+
 bool MArea::ByArea::operator()(const MArea& a, const MArea& b) const {
     // This implements a "less than" comparison, suitable for std::sort.
     // The original Java code sorts ascending and then iterates backwards
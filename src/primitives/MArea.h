@@ -3,7 +3,10 @@
 #include "MPointDouble.h"
 #include "MVector.h"
 #include "Rectangle.h"
+#include "ShapeView.h"
+#include <cstdint>
 #include <vector>
+#include <boost/container/small_vector.hpp>
 #include <boost/geometry.hpp>
 #include <boost/geometry/geometries/polygon.hpp>
 #include <boost/geometry/geometries/multi_polygon.hpp>
@@ -17,14 +20,21 @@ using MultiPolygon = bg::model::multi_polygon<Polygon>;
  * @brief Represents a piece to be placed inside a Bin.
  * This is the C++ equivalent of org.packing.primitives.MArea, which was based on java.awt.geom.Area.
  * It uses Boost.Geometry for the underlying geometric operations.
- * An MArea can be a complex shape (a polygon with holes, or multiple disjoint polygons)
- * which is represented by a Boost.Geometry multi_polygon.
+ * An MArea can be a complex shape (a polygon with holes, or multiple disjoint polygons).
+ * All its vertices live in one contiguous buffer of closed rings, so that moving, rotating
+ * and testing a piece walks a single array; Boost.Geometry reads that buffer through the
+ * views of ShapeView.h. The bounding box is cached.
+ * Axis-aligned rectangles are recognised whenever the shape is set: their bounding box is the
+ * whole shape, so they rotate by quarter turns and test collisions against one another with
+ * interval comparisons only, without Boost.Geometry.
  */
 class MArea {
 public:
     MArea();
     MArea(const std::vector<MPointDouble>& points, int id);
+    MArea(const double* xy, size_t vertexCount, int id); // Interleaved x, y coordinates, copied straight into the ring.
     MArea(const MArea& outer, const MArea& inner); // For creating holes
+    MArea(MultiPolygon shape, int id, double rotation); // Takes the geometry as is, e.g. when deserializing.
 
     int getID() const;
     double getArea() const;
@@ -32,11 +42,19 @@ public:
     Rectangle2D getBoundingBox2D() const;
     double getFreeArea() const;
     size_t getVertexCount() const;
+    bool isRectangle() const; // An axis-aligned rectangle, equal to its bounding box.
+    size_t getMemoryUsage() const; // Heap bytes held by the shape (vertices and ring offsets).
+    MultiPolygon getShape() const; // A Boost.Geometry copy of the shape; prefer view() in hot paths.
+    ShapeView::MultiPolygonView view() const; // Valid until the piece is changed.
+    ShapeView::RingSpan vertices() const; // All the rings, one after the other.
 
     void add(const MArea& other);
     void subtract(const MArea& other);
     void intersect(const MArea& other);
     bool intersection(const MArea& other) const;
+    // How far this piece can move straight down before it touches below, infinity if it never does.
+    // The pieces must not overlap to begin with.
+    double dropDistance(const MArea& below) const;
 
     bool isEmpty() const;
     bool isInside(const Rectangle2D& rect) const;
@@ -44,6 +62,7 @@ public:
     void move(const MVector& vector);
     void rotate(double degrees);
     void placeInPosition(double x, double y);
+    void snapToGrid(double scale); // Rounds every vertex to a multiple of 1 / scale (see FixedPoint).
 
     // Comparators
     struct ByArea {
@@ -51,10 +70,21 @@ public:
     };
 
 private:
-    MultiPolygon shape;
+    // Closed rings, polygon by polygon, outer ring first. ringEnds[r] is the end offset of ring r in
+    // vertices and polygonRingEnds[p] the end index of polygon p in ringEnds; the offsets of the usual
+    // single-ring piece are stored inline.
+    std::vector<MPointDouble> vertexBuffer;
+    boost::container::small_vector<uint32_t, 2> ringEnds;
+    boost::container::small_vector<uint32_t, 1> polygonRingEnds;
+    Rectangle2D bbox;
+    bool rectangle;
     int id;
     double rotation;
 
+    void assign(const MultiPolygon& shape);
+    void detectRectangle();
+    void rotateQuarterTurns(int quarterTurns);
+    void updateBoundingBox();
     void updateArea();
     double area;
 };
\ No newline at end of file
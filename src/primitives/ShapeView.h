@@ -0,0 +1,134 @@
+#pragma once
+
+#include "MPointDouble.h"
+#include <boost/geometry/core/closure.hpp>
+#include <boost/geometry/core/exterior_ring.hpp>
+#include <boost/geometry/core/interior_rings.hpp>
+#include <boost/geometry/core/point_order.hpp>
+#include <boost/geometry/core/ring_type.hpp>
+#include <boost/geometry/core/tags.hpp>
+#include <boost/container/small_vector.hpp>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Read-only views over a flat vertex buffer, registered with Boost.Geometry.
+ *
+ * MArea keeps all the vertices of a piece in one contiguous array. These views let the
+ * Boost.Geometry algorithms (intersects, area, envelope, boolean operations) read that
+ * array in place: a RingSpan is a [first, last) range of closed, clockwise vertices, a
+ * PolygonView an outer ring plus a range of hole spans, and a MultiPolygonView a range of
+ * PolygonView. The views hold pointers, so they are only valid while the buffer is alive
+ * and unchanged.
+ */
+namespace ShapeView {
+
+/**
+ * @brief A contiguous range of elements, usable as a Boost.Range.
+ */
+template <typename T>
+struct Span {
+    using value_type = T;
+    using iterator = const T*;
+    using const_iterator = const T*;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+    const T* first = nullptr;
+    const T* last = nullptr;
+
+    const T* begin() const { return first; }
+    const T* end() const { return last; }
+    std::size_t size() const { return static_cast<std::size_t>(last - first); }
+    bool empty() const { return first == last; }
+    const T& operator[](std::size_t i) const { return first[i]; }
+    const T& front() const { return *first; }
+    const T& back() const { return *(last - 1); }
+};
+
+using RingSpan = Span<MPointDouble>;
+
+struct PolygonView {
+    RingSpan outer;
+    Span<RingSpan> inners;
+};
+
+/**
+ * @brief A multi-polygon over a flat vertex buffer. Registered with Boost.Geometry as a multi_polygon.
+ * The polygons and hole spans are built on construction, inline for the usual few rings. The
+ * polygons point into this object, so it can be neither copied nor moved.
+ */
+class MultiPolygonView {
+public:
+    using value_type = PolygonView;
+    using iterator = const PolygonView*;
+    using const_iterator = const PolygonView*;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+    /**
+     * @param vertices The closed rings, one after the other.
+     * @param ringEnds Offset in vertices of the end of each ring.
+     * @param polygonRingEnds Index in ringEnds of the end of each polygon; the first ring of a polygon is its outer ring.
+     */
+    MultiPolygonView(const MPointDouble* vertices, Span<uint32_t> ringEnds, Span<uint32_t> polygonRingEnds) {
+        holes.reserve(ringEnds.size() - polygonRingEnds.size());
+        polygons.reserve(polygonRingEnds.size());
+        uint32_t ring = 0;
+        uint32_t vertex = 0;
+        for (uint32_t polygonEnd : polygonRingEnds) {
+            PolygonView polygon;
+            polygon.outer = {vertices + vertex, vertices + ringEnds[ring]};
+            vertex = ringEnds[ring++];
+            size_t firstHole = holes.size();
+            for (; ring < polygonEnd; ++ring) {
+                holes.push_back({vertices + vertex, vertices + ringEnds[ring]});
+                vertex = ringEnds[ring];
+            }
+            polygons.push_back(polygon);
+            polygons.back().inners = {holes.data() + firstHole, holes.data() + holes.size()};
+        }
+    }
+
+    MultiPolygonView(const MultiPolygonView&) = delete;
+    MultiPolygonView& operator=(const MultiPolygonView&) = delete;
+
+    const PolygonView* begin() const { return polygons.data(); }
+    const PolygonView* end() const { return polygons.data() + polygons.size(); }
+    std::size_t size() const { return polygons.size(); }
+    bool empty() const { return polygons.empty(); }
+    const PolygonView& operator[](std::size_t i) const { return polygons[i]; }
+
+private:
+    // Reserved up front, so the hole spans handed to the polygons never move.
+    boost::container::small_vector<RingSpan, 4> holes;
+    boost::container::small_vector<PolygonView, 2> polygons;
+};
+
+} // namespace ShapeView
+
+namespace boost { namespace geometry { namespace traits {
+
+template <> struct tag<ShapeView::RingSpan> { using type = ring_tag; };
+template <> struct point_order<ShapeView::RingSpan> { static const order_selector value = clockwise; };
+template <> struct closure<ShapeView::RingSpan> { static const closure_selector value = closed; };
+
+template <> struct tag<ShapeView::PolygonView> { using type = polygon_tag; };
+template <> struct ring_const_type<ShapeView::PolygonView> { using type = const ShapeView::RingSpan&; };
+template <> struct ring_mutable_type<ShapeView::PolygonView> { using type = ShapeView::RingSpan&; };
+template <> struct interior_const_type<ShapeView::PolygonView> { using type = const ShapeView::Span<ShapeView::RingSpan>&; };
+template <> struct interior_mutable_type<ShapeView::PolygonView> { using type = ShapeView::Span<ShapeView::RingSpan>&; };
+
+template <> struct exterior_ring<ShapeView::PolygonView> {
+    static const ShapeView::RingSpan& get(const ShapeView::PolygonView& p) { return p.outer; }
+    static ShapeView::RingSpan& get(ShapeView::PolygonView& p) { return p.outer; }
+};
+
+template <> struct interior_rings<ShapeView::PolygonView> {
+    static const ShapeView::Span<ShapeView::RingSpan>& get(const ShapeView::PolygonView& p) { return p.inners; }
+    static ShapeView::Span<ShapeView::RingSpan>& get(ShapeView::PolygonView& p) { return p.inners; }
+};
+
+template <> struct tag<ShapeView::MultiPolygonView> { using type = multi_polygon_tag; };
+
+}}} // namespace boost::geometry::traits
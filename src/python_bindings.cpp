@@ -1,16 +1,78 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>       // For automatic vector/optional conversions
 #include <pybind11/operators.h> // For operator overloads
+#include <pybind11/functional.h> // For the progress callback
+#include <pybind11/chrono.h>     // For the progress interval
+#include <pybind11/numpy.h>      // For vertex arrays
 
 #include "core/Bin.h"
 #include "core/BinPacking.h"
+#include "core/Stats.h"
+#include "core/Progress.h"
+#include "core/PackingConfig.h"
+#include "core/Validation.h"
 #include "utils/Utils.h"
+#include "utils/Trace.h"
+#include "utils/ThreadPool.h"
+#include "utils/Serialization.h"
 #include "primitives/MArea.h"
 #include "primitives/Rectangle.h"
 #include "primitives/MPointDouble.h"
 
 namespace py = pybind11;
 
+namespace {
+    // Vertex arrays are read through the buffer protocol: a C-contiguous float64 array is read in
+    // place, anything else (other dtypes, strides, nested lists) is converted by NumPy once.
+    using CoordinateArray = py::array_t<double, py::array::c_style | py::array::forcecast>;
+    using OffsetArray = py::array_t<int64_t, py::array::c_style | py::array::forcecast>;
+    using IdArray = py::array_t<int, py::array::c_style | py::array::forcecast>;
+
+    void checkCoordinates(const CoordinateArray& xy, const char* name) {
+        if (xy.ndim() != 2 || xy.shape(1) != 2) {
+            throw py::value_error(std::string(name) + " must be an array of shape (N, 2)");
+        }
+    }
+
+    // Hands a vector over to NumPy without copying: the array keeps the vector alive through a capsule.
+    template <typename T>
+    py::array_t<T> toArray(std::vector<T>&& values, std::vector<py::ssize_t> shape) {
+        auto* owned = new std::vector<T>(std::move(values));
+        py::capsule owner(owned, [](void* p) { delete static_cast<std::vector<T>*>(p); });
+        return py::array_t<T>(shape, owned->data(), owner);
+    }
+
+    // Bins are borrowed from the Python sequence rather than converted, which would copy every piece.
+    std::vector<const Bin*> borrowBins(const py::sequence& bins) {
+        std::vector<const Bin*> result;
+        result.reserve(bins.size());
+        for (const auto& bin : bins) {
+            result.push_back(&bin.cast<const Bin&>());
+        }
+        return result;
+    }
+
+    py::bytes toBytes(const Serialization::Bytes& bytes) {
+        return py::bytes(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+    }
+
+    // Deserializes from a bytes object in place; the reason of a failure is printed by Serialization.
+    template <typename Deserialize>
+    auto fromBytes(const py::bytes& bytes, Deserialize deserialize) {
+        char* data = nullptr;
+        py::ssize_t size = 0;
+        PyBytes_AsStringAndSize(bytes.ptr(), &data, &size);
+        auto result = deserialize(reinterpret_cast<const uint8_t*>(data), static_cast<size_t>(size));
+        if (!result) {
+            throw py::value_error("invalid or incompatible serialized data");
+        }
+        return std::move(*result);
+    }
+}
+
+PYBIND11_NUMPY_DTYPE_EX(BinPacking::PlacementRecord, binIndex, "bin_index", pieceId, "piece_id",
+                        rotation, "rotation", x, "x", y, "y", area, "area");
+
 // PYBIND11_MODULE is the entry point for creating a Python module.
 // The first argument is the module name (must match the target name in CMake)
 // The second argument, `m`, is a py::module_ object that is the main interface.
@@ -49,23 +111,233 @@ PYBIND11_MODULE(packing_py, m) {
 
     py::class_<MArea>(m, "MArea")
         .def(py::init<const std::vector<MPointDouble>&, int>(), "Constructs a piece from a list of points and an ID.", py::arg("points"), py::arg("id"))
+        .def(py::init([](const CoordinateArray& xy, int id, const std::vector<CoordinateArray>& holes) {
+                 checkCoordinates(xy, "xy");
+                 MArea piece(xy.data(), static_cast<size_t>(xy.shape(0)), id);
+                 for (const auto& hole : holes) {
+                     checkCoordinates(hole, "holes");
+                     piece = MArea(piece, MArea(hole.data(), static_cast<size_t>(hole.shape(0)), -1));
+                 }
+                 return piece;
+             }),
+             "Constructs a piece from an (N, 2) array of x, y coordinates and an ID, with optional (M, 2) hole arrays.\n"
+             "The vertices are copied once, straight into the piece; no Python object is created per vertex.",
+             py::arg("xy"), py::arg("id"), py::arg("holes") = std::vector<CoordinateArray>())
         .def("get_id", &MArea::getID, "Gets the unique ID of the piece.")
         .def("get_area", &MArea::getArea, "Gets the geometric area of the piece.")
         .def("get_rotation", &MArea::getRotation, "Gets the current rotation in degrees.")
         .def("get_bounding_box", &MArea::getBoundingBox2D, "Gets the axis-aligned bounding box.")
         .def("is_empty", &MArea::isEmpty, "Checks if the area is empty.")
+        .def(py::pickle(
+            [](const MArea &a) { return toBytes(Serialization::serializePiece(a)); },
+            [](const py::bytes &state) { return fromBytes(state, Serialization::deserializePiece); }))
         .def("__repr__", [](const MArea &a) {
             return "<MArea id=" + std::to_string(a.getID()) + " area=" + std::to_string(a.getArea()) + ">";
         });
 
+    // --- Bind Statistics ---
+
+    py::class_<Stats::Counters>(m, "Counters")
+        .def_readonly("rtree_queries", &Stats::Counters::rtreeQueries, "Broad-phase queries issued to the spatial index.")
+        .def_readonly("broad_phase_candidates", &Stats::Counters::broadPhaseCandidates, "Candidates returned by the broad phase.")
+        .def_readonly("narrow_phase_tests", &Stats::Counters::narrowPhaseTests, "Exact intersection tests performed.")
+        .def_readonly("compress_steps", &Stats::Counters::compressSteps, "Unit moves attempted while compressing.")
+        .def_readonly("sweep_cells", &Stats::Counters::sweepCells, "Grid positions visited by sweep.")
+        .def_readonly("dive_slots", &Stats::Counters::diveSlots, "Horizontal start positions tried by dive.")
+        .def_readonly("free_rectangles_high_water", &Stats::Counters::freeRectanglesHighWater, "Largest free-rectangle list seen.")
+        .def("__repr__", [](const Stats::Counters &c) {
+            return "<Counters rtree_queries=" + std::to_string(c.rtreeQueries) +
+                   " narrow_phase_tests=" + std::to_string(c.narrowPhaseTests) +
+                   " compress_steps=" + std::to_string(c.compressSteps) + ">";
+        });
+
+    // Stages are exposed as a dict keyed by stage name, e.g. stats.stages["compress"].
+    auto stagesToDict = [](const std::array<Stats::Counters, Stats::STAGE_COUNT>& stages) {
+        py::dict result;
+        for (size_t s = 0; s < Stats::STAGE_COUNT; ++s) {
+            result[Stats::stageName(static_cast<Stats::Stage>(s))] = stages[s];
+        }
+        return result;
+    };
+
+    // Byte counts are exposed as dicts keyed by category name, e.g. usage.peak_bytes["rtree"].
+    auto categoriesToDict = [](const std::array<uint64_t, Stats::MEMORY_CATEGORY_COUNT>& bytes) {
+        py::dict result;
+        for (size_t c = 0; c < Stats::MEMORY_CATEGORY_COUNT; ++c) {
+            result[Stats::memoryCategoryName(static_cast<Stats::MemoryCategory>(c))] = bytes[c];
+        }
+        return result;
+    };
+
+    py::class_<Stats::MemoryUsage>(m, "MemoryUsage")
+        .def_property_readonly("peak_bytes", [categoriesToDict](const Stats::MemoryUsage &u) { return categoriesToDict(u.peakBytes); }, "Peak bytes per category.")
+        .def_property_readonly("current_bytes", [categoriesToDict](const Stats::MemoryUsage &u) { return categoriesToDict(u.currentBytes); }, "Bytes held per category when the stage last finished.")
+        .def_readonly("peak_total_bytes", &Stats::MemoryUsage::peakTotalBytes, "Peak of the bytes summed over all categories.")
+        .def_property_readonly("current_total_bytes", &Stats::MemoryUsage::currentTotalBytes, "Bytes held, summed over all categories.")
+        .def("__repr__", [](const Stats::MemoryUsage &u) {
+            return "<MemoryUsage peak_total_bytes=" + std::to_string(u.peakTotalBytes) +
+                   " current_total_bytes=" + std::to_string(u.currentTotalBytes()) + ">";
+        });
+
+    auto memoryToDict = [](const std::array<Stats::MemoryUsage, Stats::STAGE_COUNT>& memory) {
+        py::dict result;
+        for (size_t s = 0; s < Stats::STAGE_COUNT; ++s) {
+            result[Stats::stageName(static_cast<Stats::Stage>(s))] = memory[s];
+        }
+        return result;
+    };
+
+    py::class_<Stats::LatencyHistogram>(m, "LatencyHistogram")
+        .def_property_readonly("count", &Stats::LatencyHistogram::count, "Pieces recorded.")
+        .def_property_readonly("min_ns", &Stats::LatencyHistogram::min)
+        .def_property_readonly("max_ns", &Stats::LatencyHistogram::max)
+        .def_property_readonly("sum_ns", &Stats::LatencyHistogram::sum)
+        .def_property_readonly("mean_ns", &Stats::LatencyHistogram::mean)
+        .def("percentile", &Stats::LatencyHistogram::percentile, "Latency in ns below which a fraction q of the pieces fall, to the bucket resolution.", py::arg("q"))
+        .def_property_readonly("buckets", [](const Stats::LatencyHistogram &h) {
+            py::list result;
+            for (size_t i = 0; i < Stats::LatencyHistogram::BUCKET_COUNT; ++i) {
+                if (h.buckets()[i] > 0) {
+                    result.append(py::make_tuple(Stats::LatencyHistogram::bucketLowerBound(i), Stats::LatencyHistogram::bucketUpperBound(i), h.buckets()[i]));
+                }
+            }
+            return result;
+        }, "Non-empty buckets as (lower ns, upper ns inclusive, count) tuples.")
+        .def("__repr__", [](const Stats::LatencyHistogram &h) {
+            return "<LatencyHistogram count=" + std::to_string(h.count()) + " p50_ns=" + std::to_string(h.percentile(0.5)) +
+                   " p99_ns=" + std::to_string(h.percentile(0.99)) + " max_ns=" + std::to_string(h.max()) + ">";
+        });
+
+    // Latency is exposed as nested dicts keyed by stage and vertex bucket, e.g. stats.latency["compress"]["256-1023"].
+    auto latencyToDict = [](const std::array<Stats::LatencyByVertices, Stats::STAGE_COUNT>& latency) {
+        py::dict result;
+        for (size_t s = 0; s < Stats::STAGE_COUNT; ++s) {
+            py::dict byVertices;
+            for (size_t v = 0; v < Stats::VERTEX_BUCKET_COUNT; ++v) {
+                byVertices[py::str(Stats::vertexBucketName(v))] = latency[s][v];
+            }
+            result[Stats::stageName(static_cast<Stats::Stage>(s))] = byVertices;
+        }
+        return result;
+    };
+
+    py::class_<Stats::BinStats>(m, "BinStats")
+        .def_property_readonly("stages", [stagesToDict](const Stats::BinStats &s) { return stagesToDict(s.stages); }, "Counters per stage, keyed by stage name.")
+        .def_property_readonly("total", &Stats::BinStats::total, "Counters summed over all stages.")
+        .def_property_readonly("memory", [memoryToDict](const Stats::BinStats &s) { return memoryToDict(s.memory); }, "Memory usage per stage, keyed by stage name.")
+        .def_property_readonly("memory_total", &Stats::BinStats::memoryTotal, "Peak memory over all stages and the bytes held now.")
+        .def_property_readonly("latency", [latencyToDict](const Stats::BinStats &s) { return latencyToDict(s.latency); }, "Placement latency histograms, keyed by stage name and vertex bucket.");
+
+    py::class_<Stats::PackStats>(m, "PackStats")
+        .def_readonly("bins", &Stats::PackStats::bins, "Statistics of each bin.")
+        .def_property_readonly("stages", [stagesToDict](const Stats::PackStats &s) { return stagesToDict(s.stageTotals()); }, "Counters per stage summed over all bins.")
+        .def_property_readonly("total", &Stats::PackStats::total, "Counters summed over all stages and bins.")
+        .def_property_readonly("memory", [memoryToDict](const Stats::PackStats &s) { return memoryToDict(s.stageMemoryTotals()); }, "Memory usage per stage summed over all bins.")
+        .def_property_readonly("memory_total", &Stats::PackStats::memoryTotal, "Memory usage of all bins, summed; the peak is an upper bound for the job.")
+        .def_property_readonly("latency", [latencyToDict](const Stats::PackStats &s) { return latencyToDict(s.stageLatencyTotals()); }, "Placement latency histograms merged over all bins, keyed by stage name and vertex bucket.")
+        .def("report", &Stats::PackStats::report, "Formats the statistics as a text table.")
+        .def("__str__", &Stats::PackStats::report);
+
     // --- Bind Core Classes ---
 
+    py::enum_<BroadPhase>(m, "BroadPhase", "Data structure of the broad phase of the collision tests.")
+        .value("AUTO", BroadPhase::Auto)
+        .value("SCAN", BroadPhase::Scan)
+        .value("GRID", BroadPhase::Grid)
+        .value("HASH", BroadPhase::Hash)
+        .value("RTREE_LINEAR", BroadPhase::RTreeLinear)
+        .value("RTREE_QUADRATIC", BroadPhase::RTreeQuadratic)
+        .value("RTREE_RSTAR", BroadPhase::RTreeRStar);
+
+    py::class_<PackingConfig>(m, "PackingConfig")
+        .def(py::init<>(), "Default step factors.")
+        .def_readwrite("dive_horizontal_displacement_factor", &PackingConfig::diveHorizontalDisplacementFactor, "Division factor of the piece width for the start positions tried by dive.")
+        .def_readwrite("dx_sweep_factor", &PackingConfig::dxSweepFactor, "Division factor of the piece width for the horizontal sweep step.")
+        .def_readwrite("dy_sweep_factor", &PackingConfig::dySweepFactor, "Division factor of the piece height for the vertical sweep step.")
+        .def_readwrite("complex_piece_vertex_threshold", &PackingConfig::complexPieceVertexThreshold, "Pieces with more vertices are swept with the complex factors.")
+        .def_readwrite("complex_dx_sweep_factor", &PackingConfig::complexDxSweepFactor)
+        .def_readwrite("complex_dy_sweep_factor", &PackingConfig::complexDySweepFactor)
+        .def_readwrite("fixed_point_scale", &PackingConfig::fixedPointScale, "Grid units per file unit of the exact fixed-point mode; 0 for floating point.")
+        .def_readwrite("broad_phase", &PackingConfig::broadPhase, "Broad phase of the collision tests of the bins; it does not change the packing.")
+        .def_static("load", &PackingConfig::load, "Loads a 'key = value' config file, or returns None on error.", py::arg("file_name"))
+        .def("save", &PackingConfig::save, "Writes the config file. Returns True on success.", py::arg("file_name"), py::arg("comment") = "")
+        .def("__repr__", [](const PackingConfig &c) { return "<PackingConfig " + c.toString() + ">"; });
+
     py::class_<Bin>(m, "Bin")
-        .def(py::init<const Rectangle2D&>(), "Constructs a bin with given dimensions.", py::arg("dimension"))
+        .def(py::init<const Rectangle2D&, const PackingConfig&>(), "Constructs a bin with given dimensions.",
+             py::arg("dimension"), py::arg("config") = PackingConfig())
         .def_property_readonly("placed_pieces", &Bin::getPlacedPieces, "Returns a list of pieces placed in the bin.", py::return_value_policy::reference_internal)
         .def_property_readonly("n_placed", &Bin::getNPlaced, "Returns the number of pieces placed.")
         .def_property_readonly("occupied_area", &Bin::getOccupiedArea, "Returns the total area occupied by pieces.")
         .def_property_readonly("dimension", &Bin::getDimension, "Returns the bin's dimensions.", py::return_value_policy::reference_internal)
+        .def_property_readonly("config", &Bin::getConfig, "Returns the step factors of the bin.", py::return_value_policy::reference_internal)
+        .def_property_readonly("stats", &Bin::getStats, "Returns the hot-path counters of the bin, per stage.", py::return_value_policy::reference_internal)
+        // The stages run with the GIL released; the bin must not be used from another Python thread meanwhile.
+        .def("bounding_box_packing",
+             [](Bin &b, std::vector<MArea> pieces, bool useParallel) { return b.boundingBoxPacking(pieces, useParallel); },
+             py::call_guard<py::gil_scoped_release>(),
+             "Places pieces, largest first, in the free rectangles of the bin. Returns the pieces that did not fit.",
+             py::arg("pieces"), py::arg("use_parallel") = false)
+        .def("drop_pieces",
+             [](Bin &b, const std::vector<MArea>& pieces, std::optional<OffsetArray> order, bool useParallel) {
+                 std::vector<MArea> ordered;
+                 if (order) {
+                     if (order->ndim() != 1) {
+                         throw py::value_error("order must be a 1-D array of indices into pieces");
+                     }
+                     ordered.reserve(static_cast<size_t>(order->shape(0)));
+                     for (py::ssize_t i = 0; i < order->shape(0); ++i) {
+                         int64_t index = order->data()[i];
+                         if (index < 0 || static_cast<size_t>(index) >= pieces.size()) {
+                             throw py::value_error("order must be a 1-D array of indices into pieces");
+                         }
+                         ordered.push_back(pieces[static_cast<size_t>(index)]);
+                     }
+                 }
+                 py::gil_scoped_release release;
+                 return b.dropPieces(order ? ordered : pieces, useParallel);
+             },
+             "Drops pieces from the top of the bin, in list order or in the order of the index array order.
+"
+             "Returns the pieces that could not be placed.",
+             py::arg("pieces"), py::arg("order") = py::none(), py::arg("use_parallel") = false)
+        .def("compress", &Bin::compress, py::call_guard<py::gil_scoped_release>(),
+             "Moves every placed piece towards the lower-left corner.", py::arg("use_parallel") = false)
+        .def("move_and_replace", &Bin::moveAndReplace, py::call_guard<py::gil_scoped_release>(),
+             "Tries to move the pieces from index_limit on into better positions. Returns True if any piece moved.",
+             py::arg("index_limit") = 0)
+        .def("find_where_to_place",
+             [](Bin &b, const MArea& piece, bool useParallel) {
+                 Bin::Placement placement = b.findWhereToPlace(piece, useParallel);
+                 return std::make_pair(placement.rectIndex, placement.requiresRotation);
+             },
+             py::call_guard<py::gil_scoped_release>(),
+             "Returns (free rectangle index, requires 90 degree rotation) of the least wasteful fit; the index is -1 if none.",
+             py::arg("piece"), py::arg("use_parallel") = false)
+        .def_property_readonly("free_rectangles",
+             [](const Bin &b) {
+                 std::vector<Rectangle2D> rectangles = b.getFreeRectangles();
+                 std::vector<double> corners;
+                 corners.reserve(4 * rectangles.size());
+                 for (const auto& r : rectangles) {
+                     corners.insert(corners.end(), {r.min_corner().x(), r.min_corner().y(), r.max_corner().x(), r.max_corner().y()});
+                 }
+                 py::ssize_t n = static_cast<py::ssize_t>(rectangles.size());
+                 return toArray(std::move(corners), {n, 4});
+             },
+             "Maximal free rectangles as an (N, 4) array of min_x, min_y, max_x, max_y.")
+        .def("placements",
+             [](const Bin &b, int32_t binIndex) {
+                 std::vector<BinPacking::PlacementRecord> records;
+                 BinPacking::appendPlacements(b, binIndex, records);
+                 py::ssize_t n = static_cast<py::ssize_t>(records.size());
+                 return toArray(std::move(records), {n});
+             },
+             "The placed pieces as a structured array with the fields of export_placements.", py::arg("bin_index") = 0)
+        // The layout is pickled, not the statistics: an unpickled bin starts with empty stats.
+        .def(py::pickle(
+            [](const Bin &b) { return toBytes(Serialization::serializeBin(b)); },
+            [](const py::bytes &state) { return fromBytes(state, Serialization::deserializeBin); }))
         .def("__repr__", [](const Bin &b) {
             return "<Bin n_placed=" + std::to_string(b.getNPlaced()) + " occupied_area=" + std::to_string(b.getOccupiedArea()) + ">";
         });
@@ -75,17 +347,297 @@ PYBIND11_MODULE(packing_py, m) {
     py::class_<Utils::LoadResult>(m, "LoadResult")
         .def_readonly("bin_dimension", &Utils::LoadResult::binDimension)
         .def_readonly("pieces", &Utils::LoadResult::pieces)
+        .def(py::pickle(
+            [](const Utils::LoadResult &res) { return toBytes(Serialization::serializeJob(res.binDimension, res.pieces)); },
+            [](const py::bytes &state) { return fromBytes(state, Serialization::deserializeJob); }))
         .def("__repr__", [](const Utils::LoadResult &res) {
             return "<LoadResult pieces=" + std::to_string(res.pieces.size()) + ">";
         });
 
     // pybind11 automatically handles the std::optional, converting std::nullopt to None.
-    m.def("load_pieces", &Utils::loadPieces, "Loads pieces and bin dimensions from a file.", py::arg("file_name"));
+    m.def("pieces_from_arrays",
+          [](const CoordinateArray& vertices, const OffsetArray& offsets, std::optional<IdArray> ids) {
+              checkCoordinates(vertices, "vertices");
+              if (offsets.ndim() != 1 || offsets.shape(0) < 1) {
+                  throw py::value_error("offsets must be a 1-D array of n_pieces + 1 vertex indices");
+              }
+              size_t nPieces = static_cast<size_t>(offsets.shape(0)) - 1;
+              const int64_t* o = offsets.data();
+              for (size_t p = 0; p < nPieces; ++p) {
+                  if (o[p] < 0 || o[p + 1] < o[p] || o[p + 1] > vertices.shape(0)) {
+                      throw py::value_error("offsets must be non-decreasing indices into vertices");
+                  }
+              }
+              if (ids && (ids->ndim() != 1 || static_cast<size_t>(ids->shape(0)) != nPieces)) {
+                  throw py::value_error("ids must be a 1-D array of n_pieces IDs");
+              }
+
+              const double* xy = vertices.data();
+              const int* idData = ids ? ids->data() : nullptr;
+              std::vector<MArea> pieces;
+              pieces.reserve(nPieces);
+              {
+                  py::gil_scoped_release release;
+                  for (size_t p = 0; p < nPieces; ++p) {
+                      int id = idData ? idData[p] : static_cast<int>(p + 1);
+                      pieces.emplace_back(xy + 2 * o[p], static_cast<size_t>(o[p + 1] - o[p]), id);
+                  }
+              }
+              return pieces;
+          },
+          "Builds the pieces of a whole job from a flat (V, 2) vertex array and n_pieces + 1 offsets:\n"
+          "piece i is vertices[offsets[i]:offsets[i + 1]]. IDs default to 1..n_pieces, as assigned by load_pieces.",
+          py::arg("vertices"), py::arg("offsets"), py::arg("ids") = py::none());
+
+    m.def("load_pieces", &Utils::loadPieces, "Loads pieces and bin dimensions from a text or binary problem file.", py::arg("file_name"));
+
+    m.def("serialize_result", [](const py::sequence& bins) { return toBytes(Serialization::serializeResult(borrowBins(bins))); },
+          "Serializes the bins of a pack result (layout and step factors, not statistics) to compact bytes.", py::arg("bins"));
+    m.def("deserialize_result", [](const py::bytes& data) { return fromBytes(data, Serialization::deserializeResult); },
+          "Restores the bins written by serialize_result, with their spatial indexes rebuilt.", py::arg("data"));
 
     // --- Bind Main Packing Algorithm ---
 
+    py::class_<Progress::CancellationToken>(m, "CancellationToken")
+        .def(py::init<>())
+        .def("cancel", &Progress::CancellationToken::cancel, "Asks the run using this token to stop; safe to call from any thread.")
+        .def("reset", &Progress::CancellationToken::reset, "Clears the cancellation so the token can be reused.")
+        .def_property_readonly("cancelled", &Progress::CancellationToken::isCancelled, "True once cancel() has been called.");
+
+    py::class_<Progress::Report>(m, "ProgressReport")
+        .def_readonly("pieces_placed", &Progress::Report::piecesPlaced, "Pieces placed in all bins so far.")
+        .def_readonly("pieces_total", &Progress::Report::piecesTotal, "Pieces given to pack.")
+        .def_readonly("bins_opened", &Progress::Report::binsOpened, "Bins opened so far.")
+        .def_property_readonly("stage", [](const Progress::Report &r) { return Stats::stageName(r.stage); }, "Stage running in the current bin.")
+        .def_readonly("elapsed_seconds", &Progress::Report::elapsedSeconds)
+        .def_readonly("eta_seconds", &Progress::Report::etaSeconds, "Estimated time left, -1 if unknown.")
+        .def_readonly("finished", &Progress::Report::finished, "True for the last report of a run.")
+        .def_readonly("cancelled", &Progress::Report::cancelled, "True if the run was cancelled.")
+        .def("__repr__", [](const Progress::Report &r) {
+            return "<ProgressReport pieces_placed=" + std::to_string(r.piecesPlaced) + "/" + std::to_string(r.piecesTotal) +
+                   " bins_opened=" + std::to_string(r.binsOpened) + " stage=" + Stats::stageName(r.stage) + ">";
+        });
+
     // The pack function takes a vector by non-const reference because it sorts it internally.
     // pybind11 will automatically convert a Python list of MArea objects to a std::vector<MArea>.
-    m.def("pack", &BinPacking::pack, "Main packing algorithm. Takes a list of pieces and bin dimensions, returns a list of bins.",
-          py::arg("pieces"), py::arg("bin_dimension"), py::arg("use_parallel") = false);
+    // pack runs without the GIL, so other Python threads keep running. The progress callback is
+    // still called on the thread running pack; pybind11 re-acquires the GIL around each call, so
+    // it may call cancel_token.cancel() itself, e.g. to enforce a deadline.
+    m.def("pack",
+          [](std::vector<MArea>& pieces, const Rectangle2D& binDimension, bool useParallel,
+             Progress::Callback progress, std::chrono::milliseconds progressInterval,
+             const Progress::CancellationToken* cancelToken, const PackingConfig& config) {
+              BinPacking::PackOptions options;
+              options.useParallel = useParallel;
+              options.config = config;
+              options.onProgress = std::move(progress);
+              options.progressInterval = progressInterval;
+              options.cancellation = cancelToken;
+              return BinPacking::pack(pieces, binDimension, options);
+          },
+          py::call_guard<py::gil_scoped_release>(),
+          "Main packing algorithm. Takes a list of pieces and bin dimensions, returns a list of bins.\n"
+          "The GIL is released while packing. progress is called with a ProgressReport at most once per\n"
+          "progress_interval; if cancel_token is cancelled the bins packed so far are returned.",
+          py::arg("pieces"), py::arg("bin_dimension"), py::arg("use_parallel") = false,
+          py::arg("progress") = py::none(), py::arg("progress_interval") = std::chrono::milliseconds(200),
+          py::arg("cancel_token") = py::none(), py::arg("config") = PackingConfig());
+
+    // pack_many converts every problem while it holds the GIL, then packs them all with the GIL released.
+    m.def("pack_many",
+          [](const py::sequence& problems, size_t threads, bool useParallel, const PackingConfig& config,
+             const Progress::CancellationToken* cancelToken) {
+              std::vector<BinPacking::PackJob> jobs;
+              jobs.reserve(problems.size());
+              for (size_t i = 0; i < problems.size(); ++i) {
+                  py::object problem = problems[i];
+                  BinPacking::PackJob job;
+                  job.options.useParallel = useParallel;
+                  job.options.config = config;
+                  job.options.cancellation = cancelToken;
+                  if (py::isinstance<Utils::LoadResult>(problem)) {
+                      const auto& loaded = problem.cast<const Utils::LoadResult&>();
+                      job.pieces = loaded.pieces;
+                      job.binDimension = loaded.binDimension;
+                  } else {
+                      py::tuple t = problem.cast<py::tuple>();
+                      if (t.size() < 2 || t.size() > 3) {
+                          throw py::value_error("each problem must be a LoadResult or a (pieces, bin_dimension[, options]) tuple");
+                      }
+                      job.pieces = t[0].cast<std::vector<MArea>>();
+                      job.binDimension = t[1].cast<Rectangle2D>();
+                      if (t.size() == 3 && !t[2].is_none()) {
+                          if (py::isinstance<PackingConfig>(t[2])) {
+                              job.options.config = t[2].cast<PackingConfig>();
+                          } else {
+                              py::dict options = t[2].cast<py::dict>();
+                              if (options.contains("use_parallel")) job.options.useParallel = options["use_parallel"].cast<bool>();
+                              if (options.contains("config")) job.options.config = options["config"].cast<PackingConfig>();
+                          }
+                      }
+                  }
+                  jobs.push_back(std::move(job));
+              }
+
+              std::vector<std::vector<Bin>> results;
+              {
+                  py::gil_scoped_release release;
+                  results = BinPacking::packMany(jobs, threads);
+              }
+              return results;
+          },
+          "Packs independent problems side by side on native threads and returns their bins in order.\n"
+          "Each problem is a LoadResult or a (pieces, bin_dimension[, options]) tuple, where options is a\n"
+          "PackingConfig or a dict with 'use_parallel' and/or 'config' overriding the keyword arguments.\n"
+          "threads=0 uses the library's shared pool (one worker per hardware thread).",
+          py::arg("problems"), py::arg("threads") = 0, py::arg("use_parallel") = false,
+          py::arg("config") = PackingConfig(), py::arg("cancel_token") = py::none());
+
+    // pack_async runs the job on the library's thread pool and completes a concurrent.futures.Future.
+    // The job owns Python references (the future, the cancel token), so it is only ever destroyed
+    // with the GIL held.
+    struct AsyncPackJob {
+        py::object future;
+        py::object cancelToken; // Keeps the token alive while the job runs.
+        std::vector<MArea> pieces;
+        Rectangle2D binDimension;
+        BinPacking::PackOptions options;
+
+        ~AsyncPackJob() {
+            py::gil_scoped_acquire gil;
+            future = py::object();
+            cancelToken = py::object();
+        }
+    };
+
+    m.def("pack_async",
+          [](std::vector<MArea> pieces, const Rectangle2D& binDimension, bool useParallel,
+             Progress::Callback progress, std::chrono::milliseconds progressInterval,
+             py::object cancelToken, const PackingConfig& config) {
+              auto job = std::make_shared<AsyncPackJob>();
+              job->future = py::module_::import("concurrent.futures").attr("Future")();
+              job->cancelToken = cancelToken;
+              job->pieces = std::move(pieces);
+              job->binDimension = binDimension;
+              job->options.useParallel = useParallel;
+              job->options.config = config;
+              job->options.onProgress = std::move(progress);
+              job->options.progressInterval = progressInterval;
+              job->options.cancellation = cancelToken.is_none() ? nullptr : cancelToken.cast<const Progress::CancellationToken*>();
+              py::object future = job->future;
+
+              ThreadPool::shared().submit([job]() {
+                  {
+                      py::gil_scoped_acquire gil;
+                      if (!job->future.attr("set_running_or_notify_cancel")().cast<bool>()) {
+                          return; // Cancelled through Future.cancel() before it started.
+                      }
+                  }
+                  std::vector<Bin> bins;
+                  std::string error;
+                  try {
+                      bins = BinPacking::pack(job->pieces, job->binDimension, job->options);
+                  } catch (const std::exception& e) {
+                      error = e.what();
+                  }
+                  py::gil_scoped_acquire gil;
+                  if (error.empty()) {
+                      job->future.attr("set_result")(py::cast(std::move(bins)));
+                  } else {
+                      job->future.attr("set_exception")(py::module_::import("builtins").attr("RuntimeError")(error));
+                  }
+              });
+              return future;
+          },
+          "Queues a pack run on the library's thread pool and returns a concurrent.futures.Future of the\n"
+          "list of bins; use asyncio.wrap_future to await it. Takes the same arguments as pack; the\n"
+          "progress callback is called from a pool thread.",
+          py::arg("pieces"), py::arg("bin_dimension"), py::arg("use_parallel") = false,
+          py::arg("progress") = py::none(), py::arg("progress_interval") = std::chrono::milliseconds(200),
+          py::arg("cancel_token") = py::none(), py::arg("config") = PackingConfig());
+
+    // Pool workers need the GIL to complete their futures, so the pool is drained at interpreter
+    // exit with the GIL released, before Python is finalised.
+    py::module_::import("atexit").attr("register")(py::cpp_function([]() {
+        py::gil_scoped_release release;
+        ThreadPool::shared().shutdown();
+    }));
+
+    // --- Bind Result Export ---
+
+    m.def("export_placements",
+          [](const py::sequence& bins) {
+              std::vector<const Bin*> borrowed = borrowBins(bins);
+              std::vector<BinPacking::PlacementRecord> records;
+              {
+                  py::gil_scoped_release release;
+                  for (size_t i = 0; i < borrowed.size(); ++i) {
+                      BinPacking::appendPlacements(*borrowed[i], static_cast<int32_t>(i), records);
+                  }
+              }
+              py::ssize_t n = static_cast<py::ssize_t>(records.size());
+              return toArray(std::move(records), {n});
+          },
+          "Returns every placed piece of the bins as one structured array with the fields\n"
+          "bin_index, piece_id, rotation, x, y (minimum corner of the bounding box) and area.",
+          py::arg("bins"));
+
+    m.def("export_geometry",
+          [](const py::sequence& bins) {
+              std::vector<const Bin*> borrowed = borrowBins(bins);
+              BinPacking::PlacementGeometry geometry;
+              {
+                  py::gil_scoped_release release;
+                  for (const Bin* bin : borrowed) {
+                      BinPacking::appendGeometry(*bin, geometry);
+                  }
+              }
+              py::ssize_t nVertices = static_cast<py::ssize_t>(geometry.xy.size() / 2);
+              py::ssize_t nRingOffsets = static_cast<py::ssize_t>(geometry.ringOffsets.size());
+              py::ssize_t nPieceOffsets = static_cast<py::ssize_t>(geometry.pieceRingOffsets.size());
+              return py::make_tuple(toArray(std::move(geometry.xy), {nVertices, 2}),
+                                    toArray(std::move(geometry.ringOffsets), {nRingOffsets}),
+                                    toArray(std::move(geometry.pieceRingOffsets), {nPieceOffsets}));
+          },
+          "Returns the placed (moved and rotated) geometry as (vertices, ring_offsets, piece_ring_offsets):\n"
+          "vertices is (V, 2), ring r is vertices[ring_offsets[r]:ring_offsets[r + 1]] (open, outer ring first),\n"
+          "and piece p is rings piece_ring_offsets[p]:piece_ring_offsets[p + 1], in the order of export_placements.",
+          py::arg("bins"));
+
+    // --- Bind Tracing ---
+
+    m.def("start_trace", &Trace::start, "Starts recording a timeline of the packing stages.");
+    m.def("stop_trace", &Trace::stop, "Stops recording and writes the timeline as Chrome trace-event JSON (open it in Perfetto). Returns True on success.",
+          py::arg("file_name"));
+
+    // --- Bind Validation ---
+
+    py::class_<Validation::Disagreement>(m, "ValidationDisagreement")
+        .def_property_readonly("kind", [](const Validation::Disagreement& d) { return std::string(Validation::kindName(d.kind)); })
+        .def_property_readonly("stage", [](const Validation::Disagreement& d) { return std::string(Stats::stageName(d.stage)); })
+        .def_readonly("detail", &Validation::Disagreement::detail)
+        .def_readonly("piece_wkt", &Validation::Disagreement::pieceWkt)
+        .def_readonly("other_wkt", &Validation::Disagreement::otherWkt);
+
+    py::class_<Validation::Report>(m, "ValidationReport")
+        .def_readonly("accepted_checked", &Validation::Report::acceptedChecked)
+        .def_readonly("rejected_checked", &Validation::Report::rejectedChecked)
+        .def_readonly("disagreement_count", &Validation::Report::disagreementCount)
+        .def_readonly("disagreements", &Validation::Report::disagreements)
+        .def("ok", &Validation::Report::ok)
+        .def("__str__", &Validation::Report::format);
+
+    m.def("start_validation",
+          [](double rejectedSampleRate, size_t maxRecorded) {
+              Validation::Options options;
+              options.rejectedSampleRate = rejectedSampleRate;
+              options.maxRecorded = maxRecorded;
+              Validation::start(options);
+          },
+          "Starts re-checking the collision verdicts of the bins with the reference Boost.Geometry predicates.",
+          py::arg("rejected_sample_rate") = 0.1, py::arg("max_recorded") = 20);
+    m.def("stop_validation", &Validation::stop, "Stops validating and returns a ValidationReport.");
+
+    m.def("collect_stats", &BinPacking::collectStats, "Gathers the hot-path counters of the bins returned by pack into a PackStats object.",
+          py::arg("bins"));
 }
\ No newline at end of file
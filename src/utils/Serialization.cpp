@@ -0,0 +1,413 @@
+#include "Serialization.h"
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <type_traits>
+
+namespace Serialization {
+
+namespace {
+    static_assert(sizeof(MPointDouble) == 2 * sizeof(double), "points are written as x, y pairs");
+
+    constexpr char MAGIC[4] = {'P', 'K', '2', 'D'};
+
+    enum class Kind : uint8_t {
+        Piece = 1,
+        Bin = 2,
+        Result = 3,
+        Job = 4
+    };
+
+    class Writer {
+    public:
+        template <typename T>
+        void put(T value) {
+            static_assert(std::is_trivially_copyable<T>::value, "put() writes raw bytes");
+            putArray(&value, 1);
+        }
+
+        template <typename T>
+        void putArray(const T* values, size_t count) {
+            static_assert(std::is_trivially_copyable<T>::value, "putArray() writes raw bytes");
+            const uint8_t* bytes = reinterpret_cast<const uint8_t*>(values);
+            out.insert(out.end(), bytes, bytes + count * sizeof(T));
+        }
+
+        void header(Kind kind) {
+            putArray(MAGIC, sizeof(MAGIC));
+            put<uint16_t>(FORMAT_VERSION);
+            put<uint8_t>(static_cast<uint8_t>(kind));
+            put<uint8_t>(0); // Reserved.
+        }
+
+        void rectangle(const Rectangle2D& r) {
+            const double corners[4] = {r.min_corner().x(), r.min_corner().y(), r.max_corner().x(), r.max_corner().y()};
+            putArray(corners, 4);
+        }
+
+        void piece(const MArea& piece) {
+            ShapeView::MultiPolygonView shape = piece.view();
+            put<int32_t>(piece.getID());
+            put<double>(piece.getRotation());
+            put<uint32_t>(static_cast<uint32_t>(shape.size()));
+            for (const auto& polygon : shape) {
+                put<uint32_t>(static_cast<uint32_t>(1 + polygon.inners.size()));
+            }
+            for (const auto& polygon : shape) {
+                put<uint32_t>(static_cast<uint32_t>(polygon.outer.size()));
+                for (const auto& ring : polygon.inners) {
+                    put<uint32_t>(static_cast<uint32_t>(ring.size()));
+                }
+            }
+            // The rings are stored one after the other in the piece, so the coordinates are one block.
+            ShapeView::RingSpan vertices = piece.vertices();
+            putArray(vertices.begin(), vertices.size());
+        }
+
+        void pieces(const std::vector<MArea>& pieces) {
+            put<uint32_t>(static_cast<uint32_t>(pieces.size()));
+            for (const auto& p : pieces) {
+                piece(p);
+            }
+        }
+
+        void config(const PackingConfig& c) {
+            put<double>(c.diveHorizontalDisplacementFactor);
+            put<double>(c.dxSweepFactor);
+            put<double>(c.dySweepFactor);
+            put<uint64_t>(c.complexPieceVertexThreshold);
+            put<double>(c.complexDxSweepFactor);
+            put<double>(c.complexDySweepFactor);
+            put<double>(c.fixedPointScale);
+            put<uint8_t>(static_cast<uint8_t>(c.broadPhase));
+        }
+
+        void bin(const Bin& bin) {
+            rectangle(bin.getDimension());
+            config(bin.getConfig());
+            pieces(bin.getPlacedPieces());
+            std::vector<Rectangle2D> freeRectangles = bin.getFreeRectangles();
+            put<uint32_t>(static_cast<uint32_t>(freeRectangles.size()));
+            for (const auto& r : freeRectangles) {
+                rectangle(r);
+            }
+        }
+
+        Bytes out;
+    };
+
+    // Reads with bounds checks; the first failure is reported and sticks.
+    class Reader {
+    public:
+        Reader(const uint8_t* data, size_t size) : data(data), size(size) {}
+
+        template <typename T>
+        bool get(T& value) {
+            return getArray(&value, 1);
+        }
+
+        template <typename T>
+        bool getArray(T* values, size_t count) {
+            if (failed || count > (size - offset) / sizeof(T)) {
+                return fail("unexpected end of data");
+            }
+            std::memcpy(values, data + offset, count * sizeof(T));
+            offset += count * sizeof(T);
+            return true;
+        }
+
+        // Number of elements announced by the data, checked against what is left so that a corrupt
+        // count cannot trigger a huge allocation.
+        bool getCount(uint32_t& count, size_t minBytesEach) {
+            return get(count) && (count <= (size - offset) / minBytesEach || fail("count exceeds the data"));
+        }
+
+        bool header(Kind expected) {
+            char magic[4];
+            uint16_t version = 0;
+            uint8_t kind = 0, reserved = 0;
+            if (!getArray(magic, 4) || std::memcmp(magic, MAGIC, 4) != 0) {
+                return fail("not a packing2D binary buffer");
+            }
+            if (!get(version) || version != FORMAT_VERSION) {
+                return fail("unsupported format version " + std::to_string(version));
+            }
+            if (!get(kind) || !get(reserved) || kind != static_cast<uint8_t>(expected)) {
+                return fail("unexpected payload kind " + std::to_string(kind));
+            }
+            return true;
+        }
+
+        bool rectangle(Rectangle2D& r) {
+            double c[4];
+            if (!getArray(c, 4)) {
+                return false;
+            }
+            r = Rectangle2D(MPointDouble(c[0], c[1]), MPointDouble(c[2], c[3]));
+            return true;
+        }
+
+        std::optional<MArea> piece() {
+            int32_t id = 0;
+            double rotation = 0.0;
+            uint32_t nPolygons = 0;
+            if (!get(id) || !get(rotation) || !getCount(nPolygons, sizeof(uint32_t))) {
+                return std::nullopt;
+            }
+            std::vector<uint32_t> ringCounts(nPolygons);
+            if (!getArray(ringCounts.data(), nPolygons)) {
+                return std::nullopt;
+            }
+            size_t nRings = 0;
+            for (uint32_t n : ringCounts) {
+                if (n == 0) {
+                    fail("polygon without an outer ring");
+                    return std::nullopt;
+                }
+                nRings += n;
+            }
+            if (nRings > (size - offset) / sizeof(uint32_t)) {
+                fail("count exceeds the data");
+                return std::nullopt;
+            }
+            std::vector<uint32_t> ringSizes(nRings);
+            if (!getArray(ringSizes.data(), nRings)) {
+                return std::nullopt;
+            }
+            size_t nPoints = 0;
+            for (uint32_t n : ringSizes) {
+                nPoints += n;
+            }
+            if (nPoints > (size - offset) / (2 * sizeof(double))) {
+                fail("count exceeds the data");
+                return std::nullopt;
+            }
+
+            MultiPolygon shape;
+            shape.resize(nPolygons);
+            size_t ring = 0;
+            auto readRing = [this, &ringSizes, &ring](Polygon::ring_type& target) {
+                uint32_t n = ringSizes[ring++];
+                target.reserve(n);
+                const uint8_t* p = data + offset;
+                for (uint32_t i = 0; i < n; ++i) {
+                    double xy[2];
+                    std::memcpy(xy, p + i * sizeof(xy), sizeof(xy));
+                    target.emplace_back(xy[0], xy[1]);
+                }
+                offset += n * 2 * sizeof(double);
+            };
+            for (uint32_t i = 0; i < nPolygons; ++i) {
+                readRing(shape[i].outer());
+                shape[i].inners().resize(ringCounts[i] - 1);
+                for (auto& inner : shape[i].inners()) {
+                    readRing(inner);
+                }
+            }
+            return MArea(std::move(shape), id, rotation);
+        }
+
+        std::optional<std::vector<MArea>> pieces() {
+            uint32_t n = 0;
+            if (!getCount(n, sizeof(int32_t) + sizeof(double) + sizeof(uint32_t))) {
+                return std::nullopt;
+            }
+            std::vector<MArea> result;
+            result.reserve(n);
+            for (uint32_t i = 0; i < n; ++i) {
+                auto p = piece();
+                if (!p) {
+                    return std::nullopt;
+                }
+                result.push_back(std::move(*p));
+            }
+            return result;
+        }
+
+        bool config(PackingConfig& c) {
+            uint64_t threshold = 0;
+            uint8_t broadPhase = 0;
+            bool ok = get(c.diveHorizontalDisplacementFactor) && get(c.dxSweepFactor) && get(c.dySweepFactor) &&
+                      get(threshold) && get(c.complexDxSweepFactor) && get(c.complexDySweepFactor) && get(c.fixedPointScale) &&
+                      get(broadPhase);
+            c.complexPieceVertexThreshold = static_cast<size_t>(threshold);
+            if (ok && broadPhase > static_cast<uint8_t>(BroadPhase::RTreeRStar)) {
+                return fail("unknown broad phase");
+            }
+            c.broadPhase = static_cast<BroadPhase>(broadPhase);
+            return ok;
+        }
+
+        // Reads the fields of a bin; the caller constructs it in place.
+        struct BinFields {
+            Rectangle2D dimension;
+            PackingConfig config;
+            std::vector<MArea> pieces;
+            std::vector<Rectangle2D> freeRectangles;
+        };
+
+        std::optional<BinFields> bin() {
+            BinFields fields;
+            if (!rectangle(fields.dimension) || !config(fields.config)) {
+                return std::nullopt;
+            }
+            auto p = pieces();
+            uint32_t nFree = 0;
+            if (!p || !getCount(nFree, 4 * sizeof(double))) {
+                return std::nullopt;
+            }
+            fields.pieces = std::move(*p);
+            fields.freeRectangles.resize(nFree);
+            for (auto& r : fields.freeRectangles) {
+                if (!rectangle(r)) {
+                    return std::nullopt;
+                }
+            }
+            return fields;
+        }
+
+        bool finish() {
+            return offset == size || fail("trailing data");
+        }
+
+        bool fail(const std::string& message) {
+            if (!failed) {
+                std::cerr << "Error: Could not deserialize: " << message << " (at byte " << offset << ")." << std::endl;
+            }
+            failed = true;
+            return false;
+        }
+
+    private:
+        const uint8_t* data;
+        size_t size;
+        size_t offset = 0;
+        bool failed = false;
+    };
+}
+
+Bytes serializePiece(const MArea& piece) {
+    Writer w;
+    w.header(Kind::Piece);
+    w.piece(piece);
+    return std::move(w.out);
+}
+
+Bytes serializeBin(const Bin& bin) {
+    Writer w;
+    w.header(Kind::Bin);
+    w.bin(bin);
+    return std::move(w.out);
+}
+
+Bytes serializeResult(const std::vector<Bin>& bins) {
+    std::vector<const Bin*> pointers;
+    pointers.reserve(bins.size());
+    for (const auto& bin : bins) {
+        pointers.push_back(&bin);
+    }
+    return serializeResult(pointers);
+}
+
+Bytes serializeResult(const std::vector<const Bin*>& bins) {
+    Writer w;
+    w.header(Kind::Result);
+    w.put<uint32_t>(static_cast<uint32_t>(bins.size()));
+    for (const Bin* bin : bins) {
+        w.bin(*bin);
+    }
+    return std::move(w.out);
+}
+
+Bytes serializeJob(const Rectangle2D& binDimension, const std::vector<MArea>& pieces) {
+    Writer w;
+    w.header(Kind::Job);
+    w.rectangle(binDimension);
+    w.pieces(pieces);
+    return std::move(w.out);
+}
+
+std::optional<MArea> deserializePiece(const uint8_t* data, size_t size) {
+    Reader r(data, size);
+    if (!r.header(Kind::Piece)) {
+        return std::nullopt;
+    }
+    auto piece = r.piece();
+    if (!piece || !r.finish()) {
+        return std::nullopt;
+    }
+    return piece;
+}
+
+std::optional<Bin> deserializeBin(const uint8_t* data, size_t size) {
+    Reader r(data, size);
+    if (!r.header(Kind::Bin)) {
+        return std::nullopt;
+    }
+    auto fields = r.bin();
+    if (!fields || !r.finish()) {
+        return std::nullopt;
+    }
+    return std::optional<Bin>(std::in_place, fields->dimension, fields->config, std::move(fields->pieces), fields->freeRectangles);
+}
+
+std::optional<std::vector<Bin>> deserializeResult(const uint8_t* data, size_t size) {
+    Reader r(data, size);
+    uint32_t nBins = 0;
+    if (!r.header(Kind::Result) || !r.getCount(nBins, 4 * sizeof(double))) {
+        return std::nullopt;
+    }
+    std::vector<Bin> bins;
+    bins.reserve(nBins); // Bins are constructed in place, never relocated.
+    for (uint32_t i = 0; i < nBins; ++i) {
+        auto fields = r.bin();
+        if (!fields) {
+            return std::nullopt;
+        }
+        bins.emplace_back(fields->dimension, fields->config, std::move(fields->pieces), fields->freeRectangles);
+    }
+    if (!r.finish()) {
+        return std::nullopt;
+    }
+    return bins;
+}
+
+std::optional<Utils::LoadResult> deserializeJob(const uint8_t* data, size_t size) {
+    Reader r(data, size);
+    Utils::LoadResult result;
+    if (!r.header(Kind::Job) || !r.rectangle(result.binDimension)) {
+        return std::nullopt;
+    }
+    auto pieces = r.pieces();
+    if (!pieces || !r.finish()) {
+        return std::nullopt;
+    }
+    result.pieces = std::move(*pieces);
+    return result;
+}
+
+bool hasMagic(const uint8_t* data, size_t size) {
+    return size >= sizeof(MAGIC) && std::memcmp(data, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+bool writeFile(const std::string& fileName, const Bytes& bytes) {
+    std::ofstream out(fileName, std::ios::binary);
+    if (!out.is_open()) {
+        std::cerr << "Error: Could not create file " << fileName << std::endl;
+        return false;
+    }
+    out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    return static_cast<bool>(out);
+}
+
+std::optional<Bytes> readFile(const std::string& fileName) {
+    std::ifstream in(fileName, std::ios::binary);
+    if (!in.is_open()) {
+        std::cerr << "Error: Could not open file " << fileName << std::endl;
+        return std::nullopt;
+    }
+    return Bytes(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+} // namespace Serialization
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "core/Bin.h"
+#include "primitives/MArea.h"
+#include "primitives/Rectangle.h"
+#include "utils/Utils.h"
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Compact binary serialization of pieces, bins, pack results and problems.
+ *
+ * Every buffer starts with the magic "PK2D", a 16-bit format version and the kind of the
+ * payload. Payloads are fixed-width fields and contiguous arrays in host byte order (the
+ * version check rejects a buffer written with the other endianness): a piece is its ID,
+ * rotation, ring counts, ring sizes and then all its coordinates; a bin adds its dimension,
+ * step factors, pieces and free rectangles. Loading does no parsing or text conversion, and
+ * a bin's spatial index is rebuilt. Statistics are not serialized. Errors are reported to
+ * std::cerr and yield std::nullopt.
+ */
+namespace Serialization {
+
+constexpr uint16_t FORMAT_VERSION = 3;
+
+using Bytes = std::vector<uint8_t>;
+
+Bytes serializePiece(const MArea& piece);
+Bytes serializeBin(const Bin& bin);
+Bytes serializeResult(const std::vector<Bin>& bins);
+Bytes serializeResult(const std::vector<const Bin*>& bins); // For bins that are borrowed rather than owned.
+
+/**
+ * @brief Serializes a problem: the bin dimension and the pieces to pack.
+ * Utils::loadPieces reads such a file as well as the text format.
+ */
+Bytes serializeJob(const Rectangle2D& binDimension, const std::vector<MArea>& pieces);
+
+std::optional<MArea> deserializePiece(const uint8_t* data, size_t size);
+std::optional<Bin> deserializeBin(const uint8_t* data, size_t size);
+std::optional<std::vector<Bin>> deserializeResult(const uint8_t* data, size_t size);
+std::optional<Utils::LoadResult> deserializeJob(const uint8_t* data, size_t size);
+
+/**
+ * @brief Whether a buffer starts with the magic of this format (of any version or kind).
+ */
+bool hasMagic(const uint8_t* data, size_t size);
+
+bool writeFile(const std::string& fileName, const Bytes& bytes);
+std::optional<Bytes> readFile(const std::string& fileName);
+
+} // namespace Serialization
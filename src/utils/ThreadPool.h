@@ -0,0 +1,69 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief Fixed-size pool of worker threads running whole jobs (for example one pack run each).
+ * The parallel stages inside a job keep using TBB; this pool only overlaps independent jobs.
+ */
+class ThreadPool {
+public:
+    /**
+     * @param threads Number of workers; 0 means one per hardware thread.
+     */
+    explicit ThreadPool(size_t threads = 0);
+
+    /**
+     * @brief Runs the queued tasks to completion and joins the workers.
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Queues a task and returns a future for its result.
+     * After shutdown() the task runs on the calling thread instead.
+     */
+    template <typename F>
+    std::future<std::invoke_result_t<std::decay_t<F>>> submit(F&& task) {
+        using Result = std::invoke_result_t<std::decay_t<F>>;
+        auto packaged = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(task));
+        std::future<Result> result = packaged->get_future();
+        if (!enqueue([packaged]() { (*packaged)(); })) {
+            (*packaged)();
+        }
+        return result;
+    }
+
+    /**
+     * @brief Stops accepting tasks, runs those already queued and joins the workers. Idempotent.
+     */
+    void shutdown();
+
+    size_t size() const { return workers.size(); }
+
+    /**
+     * @brief Process-wide pool with one worker per hardware thread, created on first use.
+     */
+    static ThreadPool& shared();
+
+private:
+    bool enqueue(std::function<void()> task);
+    void workerLoop();
+
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable wakeup;
+    bool stopping = false;
+};
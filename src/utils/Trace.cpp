@@ -0,0 +1,107 @@
+#include "Trace.h"
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Trace {
+
+namespace detail {
+    std::atomic<bool> enabled{false};
+}
+
+namespace {
+
+struct Event {
+    const char* name;
+    detail::Clock::time_point begin;
+    detail::Clock::time_point end;
+    const char* argName;
+    int64_t argValue;
+};
+
+// Each thread appends to its own buffer, so parallel regions do not contend on a
+// single lock. The registry keeps the buffers alive after their thread exits.
+struct ThreadBuffer {
+    int tid = 0;
+    std::mutex mutex;
+    std::vector<Event> events;
+};
+
+std::mutex registryMutex;
+std::vector<std::shared_ptr<ThreadBuffer>> registry;
+detail::Clock::time_point origin;
+
+ThreadBuffer& localBuffer() {
+    thread_local std::shared_ptr<ThreadBuffer> buffer;
+    if (!buffer) {
+        buffer = std::make_shared<ThreadBuffer>();
+        std::lock_guard<std::mutex> lock(registryMutex);
+        buffer->tid = static_cast<int>(registry.size()) + 1;
+        registry.push_back(buffer);
+    }
+    return *buffer;
+}
+
+double toMicroseconds(detail::Clock::duration d) {
+    return std::chrono::duration<double, std::micro>(d).count();
+}
+
+} // namespace
+
+void detail::record(const char* name, Clock::time_point begin, Clock::time_point end, const char* argName, int64_t argValue) {
+    ThreadBuffer& buffer = localBuffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    buffer.events.push_back({name, begin, end, argName, argValue});
+}
+
+void start() {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (auto& buffer : registry) {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+        buffer->events.clear();
+    }
+    origin = detail::Clock::now();
+    detail::enabled.store(true, std::memory_order_relaxed);
+}
+
+bool stop(const std::string& fileName) {
+    detail::enabled.store(false, std::memory_order_relaxed);
+
+    std::ofstream out(fileName);
+    if (!out.is_open()) {
+        std::cerr << "Error: Could not create trace file " << fileName << std::endl;
+        return false;
+    }
+
+    // Event names are string literals from TRACE_SCOPE, so they need no escaping.
+    out << std::fixed << std::setprecision(3);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (auto& buffer : registry) {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+        if (buffer->events.empty()) {
+            continue;
+        }
+        out << (first ? "" : ",") << "\n{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << buffer->tid
+            << ",\"args\":{\"name\":\"thread-" << buffer->tid << "\"}}";
+        first = false;
+        for (const auto& event : buffer->events) {
+            out << ",\n{\"ph\":\"X\",\"cat\":\"packing\",\"name\":\"" << event.name << "\",\"pid\":1,\"tid\":" << buffer->tid
+                << ",\"ts\":" << toMicroseconds(event.begin - origin)
+                << ",\"dur\":" << toMicroseconds(event.end - event.begin);
+            if (event.argName) {
+                out << ",\"args\":{\"" << event.argName << "\":" << event.argValue << "}";
+            }
+            out << "}";
+        }
+        buffer->events.clear();
+    }
+    out << "\n]}\n";
+    return static_cast<bool>(out);
+}
+
+} // namespace Trace
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Optional span tracing written as Chrome trace-event JSON (viewable in Perfetto
+ * or chrome://tracing).
+ *
+ * Spans are recorded with TRACE_SCOPE. When the library is built without
+ * PACKING_ENABLE_TRACING the macro expands to nothing; otherwise a span costs a single
+ * relaxed atomic load while no trace session is running.
+ */
+namespace Trace {
+
+namespace detail {
+    extern std::atomic<bool> enabled;
+
+    using Clock = std::chrono::steady_clock;
+
+    void record(const char* name, Clock::time_point begin, Clock::time_point end, const char* argName, int64_t argValue);
+}
+
+/**
+ * @brief Whether a trace session is running.
+ */
+inline bool isEnabled() {
+    return detail::enabled.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Starts a trace session, discarding any events from a previous one.
+ */
+void start();
+
+/**
+ * @brief Stops the trace session and writes the recorded events to a file.
+ * Must be called once all traced work has finished.
+ * @param fileName Path of the JSON file to write.
+ * @return True if the file was written.
+ */
+bool stop(const std::string& fileName);
+
+/**
+ * @brief RAII span: records a complete event covering its lifetime on the calling thread.
+ * The name (and argument name) must be string literals, they are stored by pointer.
+ */
+class Span {
+public:
+    explicit Span(const char* name, const char* argName = nullptr, int64_t argValue = 0)
+        : name(isEnabled() ? name : nullptr), argName(argName), argValue(argValue) {
+        if (this->name) {
+            begin = detail::Clock::now();
+        }
+    }
+
+    ~Span() {
+        if (name) {
+            detail::record(name, begin, detail::Clock::now(), argName, argValue);
+        }
+    }
+
+    Span(const Span&) = delete;
+    Span& operator=(const Span&) = delete;
+
+private:
+    const char* name;
+    const char* argName;
+    int64_t argValue;
+    detail::Clock::time_point begin;
+};
+
+} // namespace Trace
+
+#ifndef PACKING_ENABLE_TRACING
+#define PACKING_ENABLE_TRACING 0
+#endif
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+#if PACKING_ENABLE_TRACING
+/**
+ * @brief Traces the enclosing scope: TRACE_SCOPE("name") or TRACE_SCOPE("name", "argName", value).
+ */
+#define TRACE_SCOPE(...) ::Trace::Span TRACE_CONCAT(traceSpan_, __LINE__)(__VA_ARGS__)
+#else
+#define TRACE_SCOPE(...) ((void)0)
+#endif
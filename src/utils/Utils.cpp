@@ -1,5 +1,6 @@
 #include "Utils.h"
 #include "primitives/MPointDouble.h"
+#include "utils/Serialization.h"
 #include <fstream>
 #include <sstream>
 #include <iostream>
@@ -20,6 +21,17 @@ std::vector<std::string> split(const std::string& s, char delimiter) {
 }
 
 std::optional<LoadResult> loadPieces(const std::string& fileName) {
+    // Binary problems written by Serialization::serializeJob start with its magic.
+    uint8_t magic[4] = {};
+    std::ifstream(fileName, std::ios::binary).read(reinterpret_cast<char*>(magic), sizeof(magic));
+    if (Serialization::hasMagic(magic, sizeof(magic))) {
+        auto bytes = Serialization::readFile(fileName);
+        if (!bytes) {
+            return std::nullopt;
+        }
+        return Serialization::deserializeJob(bytes->data(), bytes->size());
+    }
+
     std::ifstream file(fileName);
     if (!file.is_open()) {
         std::cerr << "Error: Could not open file " << fileName << std::endl;
@@ -44,13 +56,18 @@ std::optional<LoadResult> loadPieces(const std::string& fileName) {
     std::getline(file, line); // Consume the rest of the line after numPieces
 
     int pieceCount = 0;
-    while (pieceCount < numPieces && std::getline(file, line)) {
+    // Keep reading after the last piece so that its hole lines are not dropped.
+    while (std::getline(file, line)) {
         if (line.empty() || line.find_first_not_of(" \t\n\v\f\r") == std::string::npos) continue;
 
         std::stringstream lineStream(line);
         std::string firstToken;
         lineStream >> firstToken;
 
+        if (firstToken != "@" && pieceCount == numPieces) {
+            break; // Ignore anything after the declared number of pieces.
+        }
+
         if (firstToken == "@") { // This line defines a hole
             if (result.pieces.empty()) {
                 std::cerr << "Error: Hole definition '@' found before any piece was defined." << std::endl;
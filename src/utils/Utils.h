@@ -18,6 +18,7 @@ struct LoadResult {
 
 /**
  * @brief Loads pieces from a file according to the specified format.
+ * A binary problem written by Serialization::serializeJob is recognized by its magic and loaded as is.
  *
  * @param fileName The path to the input file.
  * @return An optional LoadResult. Returns std::nullopt if the file cannot be opened or is malformed.
@@ -0,0 +1,239 @@
+#include "WorkloadGenerator.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+namespace WorkloadGenerator {
+
+namespace {
+
+const double PI = 3.14159265358979323846;
+
+// The standard distributions are implementation-defined, so the draws are derived from
+// the raw mt19937 output to get the same instance on every platform for a given seed.
+class Random {
+public:
+    explicit Random(unsigned seed) : engine(seed) {}
+
+    double uniform() { return engine() / 4294967296.0; }
+    double uniform(double lo, double hi) { return lo + (hi - lo) * uniform(); }
+    size_t uniformInt(size_t lo, size_t hi) { return lo + static_cast<size_t>(uniform() * (hi - lo + 1)); }
+
+    double normal() {
+        // Box-Muller transform.
+        double u1 = 1.0 - uniform();
+        double u2 = uniform();
+        return std::sqrt(-2.0 * std::log(u1)) * std::cos(2.0 * PI * u2);
+    }
+
+private:
+    std::mt19937 engine;
+};
+
+double roundTo(double value, double scale) {
+    return std::round(value * scale) / scale;
+}
+
+double drawSize(Random& rng, const Options& o, double maxFit) {
+    double lo = std::min(o.minSize, maxFit);
+    double hi = std::min(o.maxSize, maxFit);
+    double size = lo;
+    switch (o.sizeDistribution) {
+        case SizeDistribution::Uniform:
+            size = rng.uniform(lo, hi);
+            break;
+        case SizeDistribution::LogNormal: {
+            double logLo = std::log(lo), logHi = std::log(hi);
+            double mu = logLo + 0.25 * (logHi - logLo);
+            double sigma = (logHi - logLo) / 4.0;
+            size = std::exp(mu + sigma * rng.normal());
+            break;
+        }
+        case SizeDistribution::Bimodal: {
+            double quarter = 0.25 * (hi - lo);
+            size = rng.uniform() < 0.7 ? rng.uniform(lo, lo + quarter) : rng.uniform(hi - quarter, hi);
+            break;
+        }
+    }
+    return std::clamp(size, lo, hi);
+}
+
+std::vector<MPointDouble> rectangle(double x, double y, double w, double h) {
+    return {{x, y}, {x + w, y}, {x + w, y + h}, {x, y + h}};
+}
+
+// Counterclockwise polygon with vertices at the given angles and relative radii, scaled to
+// the ellipse inscribed in the box (x, y, w, h).
+std::vector<MPointDouble> radialPolygon(double x, double y, double w, double h,
+                                        const std::vector<double>& angles, const std::vector<double>& radii) {
+    std::vector<MPointDouble> points;
+    points.reserve(angles.size());
+    for (size_t i = 0; i < angles.size(); ++i) {
+        points.emplace_back(x + w / 2.0 * (1.0 + radii[i] * std::cos(angles[i])),
+                            y + h / 2.0 * (1.0 + radii[i] * std::sin(angles[i])));
+    }
+    return points;
+}
+
+// Points on an ellipse are always in convex position, so jittered sorted angles give a convex polygon.
+std::vector<MPointDouble> convexPolygon(Random& rng, double x, double y, double w, double h, size_t n) {
+    std::vector<double> angles(n), radii(n, 1.0);
+    for (size_t i = 0; i < n; ++i) {
+        angles[i] = 2.0 * PI * (i + 0.8 * rng.uniform()) / n;
+    }
+    return radialPolygon(x, y, w, h, angles, radii);
+}
+
+// Alternating outer and inner radii. An inner vertex is a reflex vertex when its radius is
+// below cos(2*pi/n), the distance to the chord joining its two neighbours.
+std::vector<MPointDouble> concavePolygon(Random& rng, double x, double y, double w, double h, size_t n) {
+    n = std::max<size_t>(n, 6);
+    double reflexLimit = std::cos(2.0 * PI / n);
+    std::vector<double> angles(n), radii(n);
+    for (size_t i = 0; i < n; ++i) {
+        angles[i] = 2.0 * PI * (i + 0.2 * rng.uniform()) / n;
+        radii[i] = (i % 2 == 0) ? 1.0 : rng.uniform(0.25, 0.9) * reflexLimit;
+    }
+    return radialPolygon(x, y, w, h, angles, radii);
+}
+
+Piece withHoles(Random& rng, double w, double h, size_t nVertices) {
+    Piece piece{ShapeKind::WithHoles, {}, {}};
+    if (rng.uniform() < 0.5) {
+        // Rectangular plate with one or two holes side by side.
+        piece.outer = rectangle(0, 0, w, h);
+        size_t nHoles = rng.uniformInt(1, 2);
+        double slot = w / nHoles;
+        for (size_t i = 0; i < nHoles; ++i) {
+            double hw = slot * rng.uniform(0.3, 0.6);
+            double hh = h * rng.uniform(0.3, 0.6);
+            double hx = i * slot + (slot - hw) / 2.0;
+            double hy = (h - hh) / 2.0;
+            piece.holes.push_back(rng.uniform() < 0.5 ? rectangle(hx, hy, hw, hh)
+                                                      : convexPolygon(rng, hx, hy, hw, hh, std::max<size_t>(nVertices / 2, 5)));
+        }
+    } else {
+        // Convex outline with a centered hole. With at least 5 jittered vertices the outline
+        // contains the ellipse scaled by 0.42, so a box of 0.4 of the size always fits.
+        piece.outer = convexPolygon(rng, 0, 0, w, h, nVertices);
+        double scale = rng.uniform(0.2, 0.4);
+        double hw = w * scale, hh = h * scale;
+        piece.holes.push_back(rectangle((w - hw) / 2.0, (h - hh) / 2.0, hw, hh));
+    }
+    return piece;
+}
+
+void roundPoints(std::vector<MPointDouble>& points, double scale) {
+    for (auto& p : points) {
+        p = MPointDouble(roundTo(p.x(), scale), roundTo(p.y(), scale));
+    }
+}
+
+} // namespace
+
+Instance generate(const Options& options) {
+    Random rng(options.seed);
+    Instance instance;
+    instance.binDimension = Rectangle2D(MPointDouble(0, 0), MPointDouble(options.binWidth, options.binHeight));
+
+    const double weights[] = {options.rectangleWeight, options.convexWeight, options.concaveWeight, options.withHolesWeight};
+    double totalWeight = 0.0;
+    for (double w : weights) totalWeight += std::max(w, 0.0);
+
+    const double maxFit = std::min(options.binWidth, options.binHeight);
+    const double scale = std::pow(10.0, options.decimals);
+    const size_t minVertices = std::max<size_t>(options.minVertices, 3);
+    const size_t maxVertices = std::max(options.maxVertices, minVertices);
+
+    instance.pieces.reserve(options.pieces);
+    for (size_t i = 0; i < options.pieces; ++i) {
+        // Pick the kind of piece by weight.
+        ShapeKind kind = ShapeKind::Rectangle;
+        double pick = rng.uniform() * totalWeight;
+        for (int k = 0; k < 4; ++k) {
+            double w = std::max(weights[k], 0.0);
+            if (pick < w) {
+                kind = static_cast<ShapeKind>(k);
+                break;
+            }
+            pick -= w;
+        }
+
+        double size = drawSize(rng, options, maxFit);
+        double other = size * rng.uniform(0.3, 1.0);
+        double w = size, h = other;
+        if (rng.uniform() < 0.5) std::swap(w, h);
+        size_t nVertices = rng.uniformInt(minVertices, maxVertices);
+
+        Piece piece{kind, {}, {}};
+        switch (kind) {
+            case ShapeKind::Rectangle: piece.outer = rectangle(0, 0, w, h); break;
+            case ShapeKind::Convex: piece.outer = convexPolygon(rng, 0, 0, w, h, nVertices); break;
+            case ShapeKind::Concave: piece.outer = concavePolygon(rng, 0, 0, w, h, nVertices); break;
+            case ShapeKind::WithHoles: piece = withHoles(rng, w, h, std::max<size_t>(nVertices, 5)); break;
+        }
+
+        roundPoints(piece.outer, scale);
+        for (auto& hole : piece.holes) {
+            roundPoints(hole, scale);
+        }
+        instance.pieces.push_back(std::move(piece));
+    }
+    return instance;
+}
+
+std::vector<MArea> toPieces(const Instance& instance) {
+    std::vector<MArea> pieces;
+    pieces.reserve(instance.pieces.size());
+    for (size_t i = 0; i < instance.pieces.size(); ++i) {
+        const Piece& generated = instance.pieces[i];
+        MArea piece(generated.outer, static_cast<int>(i + 1));
+        for (const auto& hole : generated.holes) {
+            // Same construction as the '@' lines of Utils::loadPieces.
+            piece = MArea(piece, MArea(hole, -1));
+            piece.placeInPosition(0, 0);
+        }
+        pieces.push_back(piece);
+    }
+    return pieces;
+}
+
+bool writeText(const Instance& instance, const std::string& fileName) {
+    std::ofstream out(fileName);
+    if (!out.is_open()) {
+        std::cerr << "Error: Could not create output file " << fileName << std::endl;
+        return false;
+    }
+
+    auto writePoints = [&out](const std::vector<MPointDouble>& points) {
+        for (size_t i = 0; i < points.size(); ++i) {
+            out << (i ? " " : "") << points[i].x() << "," << points[i].y();
+        }
+    };
+
+    out << std::setprecision(15);
+    out << RectangleUtils::getWidth(instance.binDimension) << " " << RectangleUtils::getHeight(instance.binDimension) << "\n";
+    out << instance.pieces.size() << "\n";
+    for (const auto& piece : instance.pieces) {
+        writePoints(piece.outer);
+        out << "\n";
+        for (const auto& hole : piece.holes) {
+            out << "@ ";
+            writePoints(hole);
+            out << "\n";
+        }
+    }
+    return static_cast<bool>(out);
+}
+
+std::optional<SizeDistribution> parseSizeDistribution(const std::string& name) {
+    if (name == "uniform") return SizeDistribution::Uniform;
+    if (name == "lognormal") return SizeDistribution::LogNormal;
+    if (name == "bimodal") return SizeDistribution::Bimodal;
+    return std::nullopt;
+}
+
+} // namespace WorkloadGenerator
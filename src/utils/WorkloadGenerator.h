@@ -0,0 +1,95 @@
+#pragma once
+
+#include "primitives/MArea.h"
+#include "primitives/MPointDouble.h"
+#include "primitives/Rectangle.h"
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Reproducible synthetic problem instances for scaling studies.
+ * The same options and seed always produce the same instance.
+ */
+namespace WorkloadGenerator {
+
+/**
+ * @brief How piece sizes (the larger side of the bounding box) are drawn between minSize and maxSize.
+ */
+enum class SizeDistribution {
+    Uniform,   // Every size equally likely.
+    LogNormal, // Many small pieces and a long tail of large ones.
+    Bimodal    // A mix of small and large pieces, few in between.
+};
+
+/**
+ * @brief The kinds of pieces the generator can produce.
+ */
+enum class ShapeKind {
+    Rectangle, // Axis-aligned rectangle.
+    Convex,    // Convex polygon with a controlled vertex count.
+    Concave,   // Star-shaped (simple, non-convex) polygon with a controlled vertex count, at least 6.
+    WithHoles  // Convex polygon or rectangle with one or two holes.
+};
+
+struct Options {
+    size_t pieces = 1000;
+    unsigned seed = 1;
+    double binWidth = 2000;
+    double binHeight = 1200;
+
+    // Relative weights of each kind of piece in the mix.
+    double rectangleWeight = 1.0;
+    double convexWeight = 1.0;
+    double concaveWeight = 1.0;
+    double withHolesWeight = 0.0;
+
+    // Vertex count of convex and concave pieces (and of the outline of pieces with holes).
+    size_t minVertices = 5;
+    size_t maxVertices = 24;
+
+    SizeDistribution sizeDistribution = SizeDistribution::Uniform;
+    double minSize = 20;
+    double maxSize = 300;
+
+    // Coordinates are rounded to this many decimals, so the text output is exact.
+    int decimals = 2;
+};
+
+/**
+ * @brief A generated piece: an outline plus optional holes, all in counterclockwise order.
+ */
+struct Piece {
+    ShapeKind kind;
+    std::vector<MPointDouble> outer;
+    std::vector<std::vector<MPointDouble>> holes;
+};
+
+struct Instance {
+    Rectangle2D binDimension;
+    std::vector<Piece> pieces;
+};
+
+/**
+ * @brief Generates an instance. Piece sizes are clamped so that every piece fits in the bin.
+ */
+Instance generate(const Options& options);
+
+/**
+ * @brief Builds the MArea pieces of an instance, with IDs 1..n as assigned by Utils::loadPieces.
+ */
+std::vector<MArea> toPieces(const Instance& instance);
+
+/**
+ * @brief Writes an instance in the text format read by Utils::loadPieces (holes as '@' lines).
+ * @return True if the file was written.
+ */
+bool writeText(const Instance& instance, const std::string& fileName);
+
+/**
+ * @brief Parses a size distribution name ("uniform", "lognormal" or "bimodal").
+ */
+std::optional<SizeDistribution> parseSizeDistribution(const std::string& name);
+
+} // namespace WorkloadGenerator
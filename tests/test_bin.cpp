@@ -109,4 +109,148 @@ TEST_F(BinTest, DropPieces_Stacking) {
     ASSERT_EQ(testBin->getNPlaced(), 2);
     Rectangle2D bbox2 = testBin->getPlacedPieces()[1].getBoundingBox2D();
     ASSERT_NEAR(RectangleUtils::getY(bbox2), RectangleUtils::getMaxY(bbox1), 1e-9);
-}
\ No newline at end of file
+}
+TEST_F(BinTest, Stats_AttributedToStages) {
+    std::vector<MArea> pieces = { createSquare(0, 0, 20, 1) };
+    testBin->boundingBoxPacking(pieces, false);
+    testBin->dropPieces({createRect(0, 0, 20, 30, 2)}, false);
+
+    const Stats::BinStats& stats = testBin->getStats();
+    const Stats::Counters& bbStage = stats.stage(Stats::Stage::BoundingBoxPacking);
+    ASSERT_EQ(bbStage.rtreeQueries, 1);
+    ASSERT_GT(bbStage.freeRectanglesHighWater, 0);
+    ASSERT_EQ(bbStage.diveSlots, 0);
+
+    const Stats::Counters& dropStage = stats.stage(Stats::Stage::DropPieces);
+    ASSERT_GT(dropStage.diveSlots, 0);
+    ASSERT_GT(dropStage.compressSteps, 0);
+    ASSERT_GT(dropStage.rtreeQueries, 0);
+
+    ASSERT_EQ(stats.total().rtreeQueries, bbStage.rtreeQueries + dropStage.rtreeQueries);
+}
+
+TEST_F(BinTest, Stats_MemoryAttributedToCategories) {
+    using Stats::MemoryCategory;
+    auto bytes = [](const std::array<uint64_t, Stats::MEMORY_CATEGORY_COUNT>& b, MemoryCategory c) {
+        return b[static_cast<size_t>(c)];
+    };
+
+    std::vector<MArea> pieces = { createSquare(0, 0, 20, 1), createSquare(0, 0, 10, 2) };
+    testBin->boundingBoxPacking(pieces, false);
+
+    const Stats::BinStats& stats = testBin->getStats();
+    const Stats::MemoryUsage& bbStage = stats.stageMemory(Stats::Stage::BoundingBoxPacking);
+    ASSERT_GT(bytes(bbStage.peakBytes, MemoryCategory::PlacedPieces), 0);
+    ASSERT_GT(bytes(bbStage.peakBytes, MemoryCategory::RTree), 0);
+    ASSERT_GT(bytes(bbStage.peakBytes, MemoryCategory::FreeRectangles), 0);
+    ASSERT_GT(bytes(bbStage.peakBytes, MemoryCategory::Temporary), 0);
+    ASSERT_GE(bbStage.peakTotalBytes, bbStage.currentTotalBytes());
+
+    // Scratch buffers are released when the stage returns; the rest is still held.
+    ASSERT_EQ(bytes(stats.currentBytes, MemoryCategory::Temporary), 0);
+    ASSERT_GT(bytes(stats.currentBytes, MemoryCategory::RTree), 0);
+
+    // A copy accounts for its own containers.
+    Bin copy = *testBin;
+    ASSERT_GT(bytes(copy.getStats().currentBytes, MemoryCategory::RTree), 0);
+    uint64_t copiedPieces = bytes(copy.getStats().currentBytes, MemoryCategory::PlacedPieces);
+    ASSERT_GT(copiedPieces, 0);
+    copy = Bin(binDimension);
+    ASSERT_LT(bytes(copy.getStats().currentBytes, MemoryCategory::PlacedPieces), copiedPieces);
+    ASSERT_GT(bytes(testBin->getStats().currentBytes, MemoryCategory::RTree), 0);
+}
+
+TEST_F(BinTest, MoveKeepsLayoutAndMemoryAccounting) {
+    using Stats::MemoryCategory;
+    std::vector<MArea> pieces = { createSquare(0, 0, 20, 1), createSquare(0, 0, 10, 2) };
+    testBin->boundingBoxPacking(pieces, false);
+    auto rtreeBytes = [](const Bin& bin) { return bin.getStats().currentBytes[static_cast<size_t>(MemoryCategory::RTree)]; };
+    uint64_t before = rtreeBytes(*testBin);
+    size_t placed = testBin->getNPlaced();
+    ASSERT_GT(placed, 0);
+
+    Bin moved(std::move(*testBin));
+    ASSERT_EQ(moved.getNPlaced(), placed);
+    ASSERT_EQ(rtreeBytes(moved), before);
+
+    // The moved bin keeps reporting its allocations into its own statistics.
+    std::vector<Bin> bins;
+    bins.push_back(std::move(moved));
+    for (int i = 0; i < 8; ++i) {
+        bins.emplace_back(binDimension); // Reallocates, moving the first bin along.
+    }
+    ASSERT_TRUE(bins[0].dropPieces({createRect(0, 0, 20, 30, 3)}, false).empty());
+    ASSERT_EQ(bins[0].getNPlaced(), placed + 1);
+    ASSERT_GE(rtreeBytes(bins[0]), before);
+    ASSERT_EQ(bins[1].getNPlaced(), 0);
+
+    // A moved-from bin can be assigned to again.
+    *testBin = bins[0];
+    ASSERT_EQ(testBin->getNPlaced(), placed + 1);
+    ASSERT_GT(rtreeBytes(*testBin), 0);
+}
+
+TEST_F(BinTest, IndexedStagesLeaveThePoolUntouched) {
+    std::vector<MArea> pool = { createSquare(0, 0, 10, 1), createSquare(0, 0, 200, 2), createSquare(0, 0, 30, 3) };
+    std::vector<size_t> indices = {0, 1, 2};
+    std::vector<size_t> notPlaced = testBin->boundingBoxPacking(pool, indices, false);
+
+    ASSERT_EQ(indices, (std::vector<size_t>{1, 2, 0})); // By decreasing area.
+    ASSERT_EQ(notPlaced.front(), 1); // Too large for the bin.
+    ASSERT_EQ(testBin->getNPlaced() + notPlaced.size(), pool.size());
+    ASSERT_EQ(pool[0].getID(), 1);
+    ASSERT_EQ(pool.size(), 3);
+
+    ASSERT_EQ(testBin->dropPieces(pool, {1}, false), std::vector<size_t>{1});
+}
+
+TEST_F(BinTest, Stats_PlacementLatencyByStageAndVertices) {
+    std::vector<MArea> pieces = { createSquare(0, 0, 20, 1), createSquare(0, 0, 10, 2) };
+    testBin->boundingBoxPacking(pieces, false);
+    testBin->dropPieces({createRect(0, 0, 20, 30, 3)}, false);
+
+    const Stats::BinStats& stats = testBin->getStats();
+    size_t squares = Stats::vertexBucket(pieces[0].getVertexCount());
+    ASSERT_EQ(squares, 0);
+    ASSERT_EQ(stats.placementLatency(Stats::Stage::BoundingBoxPacking, squares).count(), 2);
+    ASSERT_EQ(stats.placementLatency(Stats::Stage::DropPieces, squares).count(), 1);
+    ASSERT_EQ(stats.placementLatency(Stats::Stage::Compress, squares).count(), 0);
+    ASSERT_EQ(stats.placementLatency(Stats::Stage::BoundingBoxPacking, 1).count(), 0);
+}
+
+TEST(LatencyHistogramTest, BucketsAndPercentiles) {
+    using Stats::LatencyHistogram;
+    for (uint64_t v : {0ull, 3ull, 4ull, 5ull, 1000ull, 123456789ull}) {
+        size_t i = LatencyHistogram::bucketIndex(v);
+        ASSERT_LE(LatencyHistogram::bucketLowerBound(i), v);
+        ASSERT_GE(LatencyHistogram::bucketUpperBound(i), v);
+        // Relative resolution of a quarter of the value.
+        ASSERT_LE(LatencyHistogram::bucketUpperBound(i) - LatencyHistogram::bucketLowerBound(i), v / 4 + 1);
+    }
+    ASSERT_EQ(LatencyHistogram::bucketIndex(UINT64_MAX), LatencyHistogram::BUCKET_COUNT - 1);
+
+    LatencyHistogram h;
+    ASSERT_EQ(h.percentile(0.99), 0);
+    for (uint64_t i = 1; i <= 99; ++i) {
+        h.record(1000);
+    }
+    h.record(1000000);
+    ASSERT_EQ(h.count(), 100);
+    ASSERT_EQ(h.min(), 1000);
+    ASSERT_EQ(h.max(), 1000000);
+    ASSERT_LE(h.percentile(0.5), 1000 + 1000 / 4);
+    ASSERT_LE(h.percentile(0.99), 1000 + 1000 / 4);
+    ASSERT_EQ(h.percentile(1.0), 1000000);
+
+    LatencyHistogram merged;
+    merged += h;
+    merged += h;
+    ASSERT_EQ(merged.count(), 200);
+    ASSERT_EQ(merged.sum(), 2 * h.sum());
+
+    ASSERT_EQ(Stats::vertexBucket(15), 0);
+    ASSERT_EQ(Stats::vertexBucket(16), 1);
+    ASSERT_EQ(Stats::vertexBucket(5000), Stats::VERTEX_BUCKET_COUNT - 1);
+    ASSERT_EQ(Stats::vertexBucketName(1), "16-63");
+    ASSERT_EQ(Stats::vertexBucketName(Stats::VERTEX_BUCKET_COUNT - 1), "1024+");
+}
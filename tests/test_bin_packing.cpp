@@ -0,0 +1,148 @@
+#include <gtest/gtest.h>
+#include "core/BinPacking.h"
+#include "utils/WorkloadGenerator.h"
+#include <cmath>
+
+namespace {
+    WorkloadGenerator::Instance smallJob() {
+        WorkloadGenerator::Options options;
+        options.pieces = 60;
+        options.seed = 11;
+        return WorkloadGenerator::generate(options);
+    }
+
+    size_t countPlaced(const std::vector<Bin>& bins) {
+        size_t placed = 0;
+        for (const auto& bin : bins) {
+            placed += bin.getNPlaced();
+        }
+        return placed;
+    }
+}
+
+TEST(BinPackingTest, ProgressEndsWithFinishedReport) {
+    auto instance = smallJob();
+    std::vector<MArea> pieces = WorkloadGenerator::toPieces(instance);
+
+    std::vector<Progress::Report> reports;
+    BinPacking::PackOptions options;
+    options.progressInterval = std::chrono::milliseconds(0);
+    options.onProgress = [&reports](const Progress::Report& r) { reports.push_back(r); };
+    std::vector<Bin> bins = BinPacking::pack(pieces, instance.binDimension, options);
+
+    ASSERT_GT(reports.size(), 1);
+    for (size_t i = 1; i < reports.size(); ++i) {
+        ASSERT_GE(reports[i].piecesPlaced, reports[i - 1].piecesPlaced);
+        ASSERT_FALSE(reports[i - 1].finished);
+    }
+    const Progress::Report& last = reports.back();
+    ASSERT_TRUE(last.finished);
+    ASSERT_FALSE(last.cancelled);
+    ASSERT_EQ(last.piecesTotal, pieces.size());
+    ASSERT_EQ(last.piecesPlaced, countPlaced(bins));
+    ASSERT_EQ(last.binsOpened, bins.size());
+}
+
+TEST(BinPackingTest, CancellationStopsTheRun) {
+    auto instance = smallJob();
+    std::vector<MArea> pieces = WorkloadGenerator::toPieces(instance);
+    std::vector<Bin> complete = BinPacking::pack(pieces, instance.binDimension, false);
+
+    // Cancel from the progress callback as soon as the first pieces are placed.
+    Progress::CancellationToken token;
+    bool sawCancelledReport = false;
+    BinPacking::PackOptions options;
+    options.cancellation = &token;
+    options.progressInterval = std::chrono::milliseconds(0);
+    options.onProgress = [&](const Progress::Report& r) {
+        if (r.piecesPlaced > 0) {
+            token.cancel();
+        }
+        sawCancelledReport |= r.finished && r.cancelled;
+    };
+    std::vector<Bin> partial = BinPacking::pack(pieces, instance.binDimension, options);
+
+    ASSERT_TRUE(token.isCancelled());
+    ASSERT_TRUE(sawCancelledReport);
+    ASSERT_LT(countPlaced(partial), countPlaced(complete));
+    for (const auto& bin : partial) {
+        for (const auto& piece : bin.getPlacedPieces()) {
+            ASSERT_TRUE(piece.isInside(bin.getDimension()));
+        }
+    }
+
+    // An already cancelled token packs nothing.
+    std::vector<Bin> none = BinPacking::pack(pieces, instance.binDimension, options);
+    ASSERT_TRUE(none.empty());
+}
+
+TEST(BinPackingTest, PlacementExportMatchesBins) {
+    WorkloadGenerator::Options options;
+    options.pieces = 40;
+    options.seed = 5;
+    options.withHolesWeight = 1.0;
+    auto instance = WorkloadGenerator::generate(options);
+    std::vector<MArea> pieces = WorkloadGenerator::toPieces(instance);
+    std::vector<Bin> bins = BinPacking::pack(pieces, instance.binDimension, false);
+
+    std::vector<BinPacking::PlacementRecord> records = BinPacking::collectPlacements(bins);
+    BinPacking::PlacementGeometry geometry = BinPacking::collectGeometry(bins);
+    ASSERT_EQ(records.size(), countPlaced(bins));
+    ASSERT_EQ(geometry.pieceRingOffsets.size(), records.size() + 1);
+    ASSERT_EQ(geometry.ringOffsets.back() * 2, static_cast<int64_t>(geometry.xy.size()));
+
+    size_t r = 0;
+    for (size_t b = 0; b < bins.size(); ++b) {
+        for (const auto& piece : bins[b].getPlacedPieces()) {
+            const auto& record = records[r];
+            ASSERT_EQ(record.binIndex, static_cast<int32_t>(b));
+            ASSERT_EQ(record.pieceId, piece.getID());
+            ASSERT_DOUBLE_EQ(record.x, RectangleUtils::getX(piece.getBoundingBox2D()));
+            ASSERT_DOUBLE_EQ(record.area, piece.getArea());
+
+            // The exported rings enclose the area of the piece (holes wind the other way, so they subtract).
+            double area = 0.0;
+            for (int64_t ring = geometry.pieceRingOffsets[r]; ring < geometry.pieceRingOffsets[r + 1]; ++ring) {
+                int64_t begin = geometry.ringOffsets[ring];
+                int64_t end = geometry.ringOffsets[ring + 1];
+                for (int64_t v = begin; v < end; ++v) {
+                    int64_t w = v + 1 < end ? v + 1 : begin;
+                    area += geometry.xy[2 * v] * geometry.xy[2 * w + 1] - geometry.xy[2 * w] * geometry.xy[2 * v + 1];
+                }
+            }
+            ASSERT_NEAR(std::abs(area) / 2.0, piece.getArea(), 1e-6 * piece.getArea());
+            r++;
+        }
+    }
+}
+
+TEST(BinPackingTest, PackManyMatchesSequentialRuns) {
+    std::vector<BinPacking::PackJob> jobs;
+    std::vector<std::vector<Bin>> expected;
+    for (unsigned seed : {21u, 22u, 23u, 24u}) {
+        WorkloadGenerator::Options options;
+        options.pieces = 30;
+        options.seed = seed;
+        auto instance = WorkloadGenerator::generate(options);
+        std::vector<MArea> pieces = WorkloadGenerator::toPieces(instance);
+        jobs.push_back({pieces, instance.binDimension, BinPacking::PackOptions()});
+        expected.push_back(BinPacking::pack(pieces, instance.binDimension, false));
+    }
+
+    for (size_t threads : {size_t(0), size_t(2)}) {
+        std::vector<BinPacking::PackJob> batch = jobs;
+        std::vector<std::vector<Bin>> results = BinPacking::packMany(batch, threads);
+        ASSERT_EQ(results.size(), expected.size());
+        for (size_t j = 0; j < results.size(); ++j) {
+            auto got = BinPacking::collectPlacements(results[j]);
+            auto want = BinPacking::collectPlacements(expected[j]);
+            ASSERT_EQ(got.size(), want.size());
+            for (size_t i = 0; i < got.size(); ++i) {
+                ASSERT_EQ(got[i].binIndex, want[i].binIndex);
+                ASSERT_EQ(got[i].pieceId, want[i].pieceId);
+                ASSERT_DOUBLE_EQ(got[i].x, want[i].x);
+                ASSERT_DOUBLE_EQ(got[i].y, want[i].y);
+            }
+        }
+    }
+}
@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+#include "core/BinPacking.h"
+#include "primitives/FixedPoint.h"
+#include "utils/WorkloadGenerator.h"
+#include <cmath>
+#include <vector>
+
+namespace {
+    MArea createSquare(double x, double y, double side, int id) {
+        std::vector<MPointDouble> points = {
+            {x, y}, {x + side, y}, {x + side, y + side}, {x, y + side}
+        };
+        return MArea(points, id);
+    }
+
+    constexpr double SCALE = 1000;
+}
+
+TEST(FixedPointTest, OrientationAndSegments) {
+    using FixedPoint::Point;
+    ASSERT_EQ(FixedPoint::orientation({0, 0}, {10, 0}, {5, 1}), 1);
+    ASSERT_EQ(FixedPoint::orientation({0, 0}, {10, 0}, {5, -1}), -1);
+    ASSERT_EQ(FixedPoint::orientation({0, 0}, {10, 0}, {20, 0}), 0);
+    // Far from the origin the cross product no longer fits in 64 bits.
+    int64_t big = FixedPoint::MAX_COORDINATE - 1;
+    ASSERT_EQ(FixedPoint::orientation({-big, -big}, {big, big}, {big, big - 1}), -1);
+
+    ASSERT_TRUE(FixedPoint::segmentsIntersect({0, 0}, {10, 10}, {0, 10}, {10, 0}));
+    ASSERT_TRUE(FixedPoint::segmentsIntersect({0, 0}, {10, 0}, {10, 0}, {10, 5}));  // Shared endpoint.
+    ASSERT_TRUE(FixedPoint::segmentsIntersect({0, 0}, {10, 0}, {5, 0}, {15, 0}));   // Collinear overlap.
+    ASSERT_FALSE(FixedPoint::segmentsIntersect({0, 0}, {10, 0}, {11, 0}, {15, 0})); // Collinear, apart.
+    ASSERT_FALSE(FixedPoint::segmentsIntersect({0, 0}, {10, 0}, {0, 1}, {10, 1}));
+}
+
+TEST(FixedPointTest, TouchingAndSeparatedPieces) {
+    MArea a = createSquare(0, 0, 10, 1);
+    ASSERT_TRUE(FixedPoint::intersects(a, createSquare(10, 0, 10, 2), SCALE));  // Shared edge.
+    ASSERT_TRUE(FixedPoint::intersects(a, createSquare(10, 10, 5, 3), SCALE));  // Shared corner.
+    ASSERT_TRUE(FixedPoint::intersects(a, createSquare(5, 5, 10, 4), SCALE));
+    ASSERT_FALSE(FixedPoint::intersects(a, createSquare(10.001, 0, 10, 5), SCALE)); // One grid unit apart.
+    // Below the grid resolution the gap rounds away.
+    ASSERT_TRUE(FixedPoint::intersects(a, createSquare(10.0004, 0, 10, 6), SCALE));
+}
+
+TEST(FixedPointTest, ContainmentAndHoles) {
+    MArea outer = createSquare(0, 0, 10, 1);
+    MArea inner = createSquare(2, 2, 3, 2);
+    ASSERT_TRUE(FixedPoint::intersects(outer, inner, SCALE));
+    ASSERT_TRUE(FixedPoint::intersects(inner, outer, SCALE));
+
+    MArea frame(createSquare(0, 0, 10, 3), createSquare(2, 2, 6, -1));
+    ASSERT_FALSE(FixedPoint::intersects(frame, createSquare(3, 3, 4, 4), SCALE));
+    ASSERT_FALSE(FixedPoint::intersects(createSquare(3, 3, 4, 4), frame, SCALE));
+    ASSERT_TRUE(FixedPoint::intersects(frame, createSquare(2, 3, 4, 5), SCALE)); // Touches the hole's edge.
+    ASSERT_TRUE(FixedPoint::intersects(frame, createSquare(1, 1, 8, 6), SCALE));
+}
+
+// On shapes already on the grid the exact predicate agrees with Boost.Geometry's.
+TEST(FixedPointTest, MatchesBoostGeometryOnSnappedShapes) {
+    WorkloadGenerator::Options options;
+    options.pieces = 40;
+    options.seed = 5;
+    options.withHolesWeight = 1.0;
+    auto instance = WorkloadGenerator::generate(options);
+    std::vector<MArea> pieces = WorkloadGenerator::toPieces(instance);
+    for (auto& piece : pieces) {
+        piece.snapToGrid(SCALE);
+    }
+
+    size_t colliding = 0;
+    for (size_t i = 0; i < pieces.size(); ++i) {
+        for (size_t j = i + 1; j < pieces.size(); ++j) {
+            // Bring the pieces close together so that many pairs actually meet.
+            MArea moved = pieces[j];
+            Rectangle2D a = pieces[i].getBoundingBox2D();
+            Rectangle2D b = moved.getBoundingBox2D();
+            moved.move(MVector(std::round(a.min_corner().x() - b.min_corner().x() + 3 * (j % 7)),
+                               std::round(a.min_corner().y() - b.min_corner().y() + 3 * (i % 5))));
+            bool exact = FixedPoint::intersects(pieces[i], moved, SCALE);
+            ASSERT_EQ(exact, pieces[i].intersection(moved)) << "pieces " << i << " and " << j;
+            colliding += exact;
+        }
+    }
+    ASSERT_GT(colliding, 0);
+}
+
+TEST(FixedPointTest, PackKeepsPiecesOnTheGridAndApart) {
+    WorkloadGenerator::Options options;
+    options.pieces = 60;
+    options.seed = 3;
+    auto instance = WorkloadGenerator::generate(options);
+    std::vector<MArea> pieces = WorkloadGenerator::toPieces(instance);
+
+    BinPacking::PackOptions packOptions;
+    packOptions.config.fixedPointScale = SCALE;
+    std::vector<Bin> bins = BinPacking::pack(pieces, instance.binDimension, packOptions);
+
+    size_t placed = 0;
+    for (const auto& bin : bins) {
+        const auto& placedPieces = bin.getPlacedPieces();
+        placed += placedPieces.size();
+        for (size_t i = 0; i < placedPieces.size(); ++i) {
+            for (const auto& v : placedPieces[i].vertices()) {
+                ASSERT_EQ(v.x(), FixedPoint::snap(v.x(), SCALE));
+                ASSERT_EQ(v.y(), FixedPoint::snap(v.y(), SCALE));
+            }
+            for (size_t j = i + 1; j < placedPieces.size(); ++j) {
+                ASSERT_FALSE(FixedPoint::intersects(placedPieces[i], placedPieces[j], SCALE));
+            }
+        }
+    }
+    ASSERT_EQ(placed, pieces.size());
+}
@@ -3,6 +3,7 @@
 #include "primitives/MPointDouble.h"
 #include "primitives/MVector.h"
 #include "primitives/Rectangle.h"
+#include <limits>
 
 // Helper function to create a square MArea for testing.
 MArea createSquare(double x, double y, double side, int id) {
@@ -20,6 +21,18 @@ TEST(MAreaTest, ConstructionAndProperties) {
     ASSERT_NEAR(square.getArea(), 100.0, 1e-9);
 }
 
+TEST(MAreaTest, ConstructionFromCoordinateArray) {
+    // Clockwise on purpose: the winding is corrected as for a list of points.
+    const double xy[] = {0, 0, 0, 10, 10, 10, 10, 0};
+    MArea fromArray(xy, 4, 7);
+    MArea fromPoints = createSquare(0, 0, 10, 7);
+
+    ASSERT_EQ(fromArray.getID(), 7);
+    ASSERT_NEAR(fromArray.getArea(), fromPoints.getArea(), 1e-9);
+    ASSERT_EQ(fromArray.getVertexCount(), fromPoints.getVertexCount());
+    ASSERT_TRUE(MArea(xy, 0, 8).isEmpty());
+}
+
 TEST(MAreaTest, PieceWithHole) {
     MArea outer = createSquare(0, 0, 10, 2); // Area = 100
     MArea inner = createSquare(2, 2, 4, -1); // Area = 16
@@ -69,4 +82,101 @@ TEST(MAreaTest, Intersection) {
     ASSERT_TRUE(piece1.intersection(piece2));
     ASSERT_FALSE(piece1.intersection(piece3));
     ASSERT_FALSE(piece2.intersection(piece3));
-}
\ No newline at end of file
+}
+TEST(MAreaTest, FlatStorageMatchesBoostGeometry) {
+    // Two disjoint polygons, the first with a hole: three rings in one vertex buffer.
+    MArea piece(createSquare(0, 0, 10, 9), createSquare(2, 2, 4, -1));
+    piece.add(createSquare(20, 0, 5, -1));
+    piece.move(MVector(3, 4));
+    piece.rotate(90);
+
+    MultiPolygon shape = piece.getShape();
+    ASSERT_EQ(shape.size(), 2);
+    ASSERT_EQ(piece.getVertexCount(), bg::num_points(shape));
+    ASSERT_EQ(piece.vertices().size(), piece.getVertexCount());
+    ASSERT_DOUBLE_EQ(bg::area(piece.view()), bg::area(shape));
+    ASSERT_DOUBLE_EQ(piece.getArea(), bg::area(shape));
+
+    Rectangle2D envelope;
+    bg::envelope(shape, envelope);
+    ASSERT_TRUE(bg::equals(envelope, piece.getBoundingBox2D())); // The cached box follows every change.
+
+    // Inside the hole: no intersection; across the outer boundary: intersection.
+    ShapeView::MultiPolygonView view = piece.view();
+    const ShapeView::RingSpan* hole = nullptr;
+    for (const auto& polygon : view) {
+        if (!polygon.inners.empty()) {
+            hole = &polygon.inners[0];
+        }
+    }
+    ASSERT_NE(hole, nullptr);
+    Rectangle2D holeBox;
+    bg::envelope(*hole, holeBox);
+    MArea inHole = createSquare(RectangleUtils::getX(holeBox) + 1, RectangleUtils::getY(holeBox) + 1, 2, 10);
+    ASSERT_FALSE(piece.intersection(inHole));
+
+    Rectangle2D bbox = piece.getBoundingBox2D();
+    MArea across = createSquare(RectangleUtils::getX(bbox) - 1, RectangleUtils::getY(bbox) - 1, 2, 11);
+    ASSERT_TRUE(piece.intersection(across));
+}
+
+TEST(MAreaTest, RectangleFastPath) {
+    MArea rect(std::vector<MPointDouble>{{0, 0}, {30, 0}, {30, 10}, {0, 10}}, 1);
+    ASSERT_TRUE(rect.isRectangle());
+    ASSERT_FALSE(MArea(std::vector<MPointDouble>{{0, 0}, {30, 0}, {30, 10}, {10, 10}, {10, 20}, {0, 20}}, 2).isRectangle());
+    ASSERT_FALSE(MArea(std::vector<MPointDouble>{{0, 0}, {30, 0}, {20, 10}, {0, 10}}, 3).isRectangle());
+    ASSERT_FALSE(MArea(createSquare(0, 0, 10, 4), createSquare(2, 2, 2, -1)).isRectangle());
+
+    // Quarter turns swap width and height about the center, exactly, and match the general rotation.
+    for (int angle : {90, 180, 270, -90}) {
+        MArea turned = rect;
+        turned.rotate(angle);
+        ASSERT_TRUE(turned.isRectangle());
+        MultiPolygon reference = rect.getShape();
+        bg::strategy::transform::rotate_transformer<bg::degree, double, 2, 2> rotation(angle);
+        bg::strategy::transform::translate_transformer<double, 2, 2> toOrigin(-15, -5), back(15, 5);
+        MultiPolygon atOrigin, rotated, expected;
+        bg::transform(reference, atOrigin, toOrigin);
+        bg::transform(atOrigin, rotated, rotation);
+        bg::transform(rotated, expected, back);
+        const auto& points = expected[0].outer();
+        ASSERT_EQ(turned.vertices().size(), points.size());
+        for (size_t i = 0; i < points.size(); ++i) {
+            ASSERT_NEAR(turned.vertices()[i].x(), points[i].x(), 1e-9);
+            ASSERT_NEAR(turned.vertices()[i].y(), points[i].y(), 1e-9);
+        }
+        ASSERT_DOUBLE_EQ(turned.getArea(), rect.getArea());
+    }
+    MArea tilted = rect;
+    tilted.rotate(45);
+    ASSERT_FALSE(tilted.isRectangle());
+
+    // Interval tests agree with Boost.Geometry, touching included.
+    ASSERT_TRUE(rect.intersection(createSquare(30, 10, 5, 5)));
+    ASSERT_TRUE(rect.intersection(createSquare(10, 5, 5, 6)));
+    ASSERT_FALSE(rect.intersection(createSquare(30.5, 0, 5, 7)));
+    MArea triangle(std::vector<MPointDouble>{{36, 0}, {36, 20}, {26, 20}}, 8); // Boxes overlap, shapes do not.
+    ASSERT_FALSE(rect.intersection(triangle));
+}
+
+TEST(MAreaTest, DropDistance) {
+    MArea floor = createSquare(0, 0, 10, 1);
+    ASSERT_DOUBLE_EQ(createSquare(5, 14, 10, 2).dropDistance(floor), 4.0);
+    ASSERT_DOUBLE_EQ(createSquare(10, 12, 10, 3).dropDistance(floor), 2.0); // Corners meet.
+    ASSERT_EQ(createSquare(10.5, 12, 10, 4).dropDistance(floor), std::numeric_limits<double>::infinity());
+    ASSERT_EQ(floor.dropDistance(createSquare(0, 20, 10, 5)), std::numeric_limits<double>::infinity()); // Above it.
+
+    // A vertex of the falling piece lands on an edge: the tip of a triangle on a slope.
+    MArea slope(std::vector<MPointDouble>{{0, 0}, {20, 0}, {20, 10}}, 6);
+    MArea tip(std::vector<MPointDouble>{{10, 20}, {12, 30}, {8, 30}}, 7);
+    ASSERT_NEAR(tip.dropDistance(slope), 15.0, 1e-9);
+
+    // A vertex of the piece below meets an edge of the falling one: a peak under a roof.
+    MArea peak(std::vector<MPointDouble>{{0, 0}, {10, 0}, {5, 8}}, 8);
+    MArea roof(std::vector<MPointDouble>{{0, 12}, {10, 12}, {10, 20}, {0, 20}}, 9);
+    ASSERT_NEAR(roof.dropDistance(peak), 4.0, 1e-9);
+
+    // A peg falling into a notch stops on the notch floor, not on the rims.
+    MArea notched(std::vector<MPointDouble>{{0, 0}, {30, 0}, {30, 10}, {20, 10}, {20, 5}, {10, 5}, {10, 10}, {0, 10}}, 10);
+    ASSERT_NEAR(createSquare(12, 20, 6, 11).dropDistance(notched), 15.0, 1e-9);
+}
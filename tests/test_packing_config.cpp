@@ -0,0 +1,69 @@
+#include <gtest/gtest.h>
+#include "core/PackingConfig.h"
+#include <cstdio>
+#include <fstream>
+
+TEST(PackingConfigTest, DefaultsMatchConstants) {
+    PackingConfig config;
+    ASSERT_EQ(config.diveHorizontalDisplacementFactor, Constants::DIVE_HORIZONTAL_DISPLACEMENT_FACTOR);
+    ASSERT_EQ(config.dxSweepFactor, Constants::DX_SWEEP_FACTOR);
+    ASSERT_EQ(config.dySweepFactor, Constants::DY_SWEEP_FACTOR);
+}
+
+TEST(PackingConfigTest, SaveLoadRoundTrip) {
+    PackingConfig config;
+    config.diveHorizontalDisplacementFactor = 4.5;
+    config.dxSweepFactor = 12;
+    config.dySweepFactor = 3;
+    config.complexPieceVertexThreshold = 64;
+    config.complexDxSweepFactor = 3;
+    config.complexDySweepFactor = 1.5;
+    config.fixedPointScale = 1000;
+    config.broadPhase = BroadPhase::RTreeQuadratic;
+
+    std::string fileName = ::testing::TempDir() + "packing_config_roundtrip.cfg";
+    ASSERT_TRUE(config.save(fileName, "written by\nthe round-trip test"));
+    auto loaded = PackingConfig::load(fileName);
+    std::remove(fileName.c_str());
+
+    ASSERT_TRUE(loaded.has_value());
+    ASSERT_EQ(loaded->diveHorizontalDisplacementFactor, 4.5);
+    ASSERT_EQ(loaded->dxSweepFactor, 12);
+    ASSERT_EQ(loaded->dySweepFactor, 3);
+    ASSERT_EQ(loaded->complexPieceVertexThreshold, 64);
+    ASSERT_EQ(loaded->complexDxSweepFactor, 3);
+    ASSERT_EQ(loaded->complexDySweepFactor, 1.5);
+    ASSERT_EQ(loaded->fixedPointScale, 1000);
+    ASSERT_EQ(loaded->broadPhase, BroadPhase::RTreeQuadratic);
+}
+
+TEST(PackingConfigTest, RejectsUnknownKeysAndInvalidValues) {
+    std::string fileName = ::testing::TempDir() + "packing_config_invalid.cfg";
+    {
+        std::ofstream out(fileName);
+        out << "dx_sweep_factor = 8   # comment\n";
+    }
+    auto partial = PackingConfig::load(fileName);
+    ASSERT_TRUE(partial.has_value());
+    ASSERT_EQ(partial->dxSweepFactor, 8);
+    ASSERT_EQ(partial->dySweepFactor, Constants::DY_SWEEP_FACTOR);
+
+    {
+        std::ofstream out(fileName);
+        out << "dx_sweep_factr = 8\n";
+    }
+    ASSERT_FALSE(PackingConfig::load(fileName).has_value());
+
+    {
+        std::ofstream out(fileName);
+        out << "dy_sweep_factor = 0\n";
+    }
+    ASSERT_FALSE(PackingConfig::load(fileName).has_value());
+
+    {
+        std::ofstream out(fileName);
+        out << "broad_phase = kd-tree\n";
+    }
+    ASSERT_FALSE(PackingConfig::load(fileName).has_value());
+    std::remove(fileName.c_str());
+}
@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+#include "core/BinPacking.h"
+#include "utils/Serialization.h"
+#include "utils/Utils.h"
+#include "utils/WorkloadGenerator.h"
+#include <boost/geometry.hpp>
+#include <cstdio>
+
+namespace {
+    WorkloadGenerator::Instance smallJob() {
+        WorkloadGenerator::Options options;
+        options.pieces = 60;
+        options.seed = 5;
+        options.withHolesWeight = 1;
+        return WorkloadGenerator::generate(options);
+    }
+
+    void expectSamePiece(const MArea& a, const MArea& b) {
+        EXPECT_EQ(a.getID(), b.getID());
+        EXPECT_EQ(a.getRotation(), b.getRotation());
+        EXPECT_NEAR(a.getArea(), b.getArea(), 1e-9 * a.getArea()); // Recomputed from the shape.
+        EXPECT_TRUE(boost::geometry::equals(a.getShape(), b.getShape()));
+        EXPECT_EQ(a.getVertexCount(), b.getVertexCount());
+    }
+
+    void expectSameBin(const Bin& a, const Bin& b) {
+        EXPECT_TRUE(boost::geometry::equals(a.getDimension(), b.getDimension()));
+        EXPECT_EQ(a.getConfig().complexPieceVertexThreshold, b.getConfig().complexPieceVertexThreshold);
+        EXPECT_EQ(a.getConfig().dxSweepFactor, b.getConfig().dxSweepFactor);
+        EXPECT_EQ(a.getConfig().broadPhase, b.getConfig().broadPhase);
+        ASSERT_EQ(a.getNPlaced(), b.getNPlaced());
+        for (size_t i = 0; i < a.getNPlaced(); ++i) {
+            expectSamePiece(a.getPlacedPieces()[i], b.getPlacedPieces()[i]);
+        }
+        auto freeA = a.getFreeRectangles();
+        auto freeB = b.getFreeRectangles();
+        ASSERT_EQ(freeA.size(), freeB.size());
+        for (size_t i = 0; i < freeA.size(); ++i) {
+            EXPECT_TRUE(boost::geometry::equals(freeA[i], freeB[i]));
+        }
+    }
+}
+
+TEST(SerializationTest, PieceRoundTripKeepsHolesAndRotation) {
+    MArea outer({{0, 0}, {10, 0}, {10, 10}, {0, 10}}, 7);
+    MArea hole({{2, 2}, {4, 2}, {4, 4}, {2, 4}}, 0);
+    MArea piece(outer, hole);
+    piece.rotate(90);
+
+    Serialization::Bytes bytes = Serialization::serializePiece(piece);
+    auto restored = Serialization::deserializePiece(bytes.data(), bytes.size());
+    ASSERT_TRUE(restored.has_value());
+    expectSamePiece(piece, *restored);
+    EXPECT_EQ(restored->getShape()[0].inners().size(), 1);
+}
+
+TEST(SerializationTest, ResultRoundTripRestoresUsableBins) {
+    auto instance = smallJob();
+    std::vector<MArea> pieces = WorkloadGenerator::toPieces(instance);
+    std::vector<Bin> bins = BinPacking::pack(pieces, instance.binDimension, false);
+    ASSERT_FALSE(bins.empty());
+
+    Serialization::Bytes bytes = Serialization::serializeResult(bins);
+    auto restored = Serialization::deserializeResult(bytes.data(), bytes.size());
+    ASSERT_TRUE(restored.has_value());
+    ASSERT_EQ(restored->size(), bins.size());
+    for (size_t i = 0; i < bins.size(); ++i) {
+        expectSameBin(bins[i], (*restored)[i]);
+    }
+
+    // The bulk-loaded R-tree answers collision queries like the one built piece by piece.
+    Bin original = bins.back();
+    Bin copy = restored->back();
+    std::vector<MArea> probes = {MArea({{0, 0}, {15, 0}, {15, 15}, {0, 15}}, 1000)};
+    original.dropPieces(probes, false);
+    copy.dropPieces(probes, false);
+    expectSameBin(original, copy);
+}
+
+TEST(SerializationTest, JobFileIsReadByLoadPieces) {
+    auto instance = smallJob();
+    std::vector<MArea> pieces = WorkloadGenerator::toPieces(instance);
+    const std::string fileName = "serialization_job_test.bin";
+    ASSERT_TRUE(Serialization::writeFile(fileName, Serialization::serializeJob(instance.binDimension, pieces)));
+
+    auto loaded = Utils::loadPieces(fileName);
+    std::remove(fileName.c_str());
+    ASSERT_TRUE(loaded.has_value());
+    EXPECT_TRUE(boost::geometry::equals(loaded->binDimension, instance.binDimension));
+    ASSERT_EQ(loaded->pieces.size(), pieces.size());
+    for (size_t i = 0; i < pieces.size(); ++i) {
+        expectSamePiece(pieces[i], loaded->pieces[i]);
+    }
+}
+
+TEST(SerializationTest, RejectsCorruptInput) {
+    MArea piece({{0, 0}, {10, 0}, {10, 10}}, 3);
+    Serialization::Bytes bytes = Serialization::serializePiece(piece);
+
+    // Truncated at every length.
+    for (size_t size = 0; size < bytes.size(); ++size) {
+        EXPECT_FALSE(Serialization::deserializePiece(bytes.data(), size).has_value()) << size;
+    }
+    // Wrong kind, version and magic.
+    EXPECT_FALSE(Serialization::deserializeBin(bytes.data(), bytes.size()).has_value());
+    Serialization::Bytes badVersion = bytes;
+    badVersion[4] ^= 0xff;
+    EXPECT_FALSE(Serialization::deserializePiece(badVersion.data(), badVersion.size()).has_value());
+    Serialization::Bytes badMagic = bytes;
+    badMagic[0] = 'X';
+    EXPECT_FALSE(Serialization::deserializePiece(badMagic.data(), badMagic.size()).has_value());
+    // A huge polygon count must not be trusted.
+    Serialization::Bytes badCount = bytes;
+    badCount[8 + 4 + 8] = 0xff;
+    badCount[8 + 4 + 8 + 3] = 0x7f;
+    EXPECT_FALSE(Serialization::deserializePiece(badCount.data(), badCount.size()).has_value());
+    // Trailing bytes.
+    Serialization::Bytes trailing = bytes;
+    trailing.push_back(0);
+    EXPECT_FALSE(Serialization::deserializePiece(trailing.data(), trailing.size()).has_value());
+}
@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+#include "core/SpatialIndex.h"
+#include <algorithm>
+#include <map>
+#include <random>
+#include <vector>
+
+namespace {
+    Rectangle2D box(double x, double y, double w, double h) {
+        return Rectangle2D(MPointDouble(x, y), MPointDouble(x + w, y + h));
+    }
+
+    std::vector<size_t> query(SpatialIndex& index, const Rectangle2D& b) {
+        std::vector<size_t> found;
+        index.query(b, [&found](size_t i, const Rectangle2D&) { found.push_back(i); });
+        std::sort(found.begin(), found.end());
+        return found;
+    }
+
+    std::vector<size_t> bruteForce(const std::map<size_t, Rectangle2D>& boxes, const Rectangle2D& b) {
+        std::vector<size_t> found;
+        for (const auto& [i, other] : boxes) {
+            if (RectangleUtils::intersects(other, b)) {
+                found.push_back(i);
+            }
+        }
+        return found;
+    }
+}
+
+TEST(SpatialIndexTest, TouchingBoxesAreReportedOnce) {
+    SpatialIndex index(box(0, 0, 100, 100));
+    index.insert(0, box(0, 0, 10, 10));
+    index.insert(1, box(10, 0, 10, 10));
+    index.insert(2, box(0, 0, 100, 100)); // Spans every cell.
+    ASSERT_EQ(index.size(), 3);
+
+    ASSERT_EQ(query(index, box(10, 10, 5, 5)), (std::vector<size_t>{0, 1, 2}));
+    ASSERT_EQ(query(index, box(50, 50, 1, 1)), (std::vector<size_t>{2}));
+    // Boxes outside the bounds still meet the entries of the border cells.
+    ASSERT_EQ(query(index, box(-20, -20, 20.5, 20.5)), (std::vector<size_t>{0, 2}));
+}
+
+TEST(SpatialIndexTest, UpdateAndRemove) {
+    SpatialIndex index(box(0, 0, 100, 100));
+    index.insert(0, box(0, 0, 10, 10));
+    index.insert(1, box(50, 50, 10, 10));
+
+    index.update(0, box(0, 1, 10, 10)); // A unit step, within the same cells.
+    ASSERT_EQ(query(index, box(0, 0, 1, 0.5)), (std::vector<size_t>{}));
+    index.update(0, box(80, 80, 10, 10)); // Into other cells.
+    ASSERT_EQ(query(index, box(0, 0, 20, 20)), (std::vector<size_t>{}));
+    ASSERT_EQ(query(index, box(55, 55, 30, 30)), (std::vector<size_t>{0, 1}));
+
+    index.remove(1);
+    ASSERT_FALSE(index.contains(1));
+    ASSERT_TRUE(index.contains(0));
+    ASSERT_EQ(index.size(), 1);
+    ASSERT_EQ(query(index, box(55, 55, 30, 30)), (std::vector<size_t>{0}));
+}
+
+// Random inserts, moves and removals, across several rebuilds of the grid and the switch of the
+// automatic choice, against a linear scan, for every backend.
+TEST(SpatialIndexTest, MatchesBruteForce) {
+    for (BroadPhase broadPhase : {BroadPhase::Auto, BroadPhase::Scan, BroadPhase::Grid, BroadPhase::Hash,
+                                  BroadPhase::RTreeLinear, BroadPhase::RTreeQuadratic, BroadPhase::RTreeRStar}) {
+        SCOPED_TRACE(broadPhaseName(broadPhase));
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<double> position(-10, 500);
+        std::uniform_real_distribution<double> side(1, 60);
+        auto randomBox = [&]() { return box(position(rng), position(rng), side(rng), side(rng)); };
+
+        SpatialIndex index(box(0, 0, 500, 500), broadPhase);
+        std::map<size_t, Rectangle2D> boxes;
+        for (size_t i = 0; i < 300; ++i) {
+            boxes[i] = randomBox();
+            index.insert(i, boxes[i]);
+        }
+        for (size_t step = 0; step < 600; ++step) {
+            size_t i = rng() % 300;
+            if (step % 5 == 4 && boxes.count(i)) {
+                index.remove(i);
+                boxes.erase(i);
+            } else if (boxes.count(i)) {
+                boxes[i] = randomBox();
+                index.update(i, boxes[i]);
+            }
+            Rectangle2D probe = randomBox();
+            ASSERT_EQ(query(index, probe), bruteForce(boxes, probe)) << "step " << step;
+        }
+        ASSERT_EQ(index.size(), boxes.size());
+
+        SpatialIndex copy(index, SpatialIndex::Allocator());
+        ASSERT_EQ(copy.current(), index.current());
+        Rectangle2D probe = box(100, 100, 200, 200);
+        ASSERT_EQ(query(copy, probe), bruteForce(boxes, probe));
+    }
+}
+
+TEST(SpatialIndexTest, AutomaticChoiceFollowsTheCount) {
+    SpatialIndex index(box(0, 0, 1000, 1000));
+    ASSERT_EQ(index.current(), BroadPhase::Scan);
+    for (size_t i = 0; i < SpatialIndex::SCAN_LIMIT; ++i) {
+        index.insert(i, box(static_cast<double>(i % 16) * 60, static_cast<double>(i / 16) * 60, 50, 50));
+        ASSERT_EQ(index.current(), i + 1 < SpatialIndex::SCAN_LIMIT ? BroadPhase::Scan : BroadPhase::Grid);
+    }
+    ASSERT_EQ(query(index, box(0, 0, 50, 50)), (std::vector<size_t>{0}));
+
+    // A requested structure is kept whatever the count.
+    SpatialIndex fixed(box(0, 0, 1000, 1000), BroadPhase::RTreeRStar);
+    for (size_t i = 0; i < SpatialIndex::SCAN_LIMIT; ++i) {
+        fixed.insert(i, box(static_cast<double>(i), 0, 1, 1));
+    }
+    ASSERT_EQ(fixed.current(), BroadPhase::RTreeRStar);
+
+    // Swapping indexes of different structures exchanges them whole.
+    index.swap(fixed);
+    ASSERT_EQ(index.current(), BroadPhase::RTreeRStar);
+    ASSERT_EQ(fixed.current(), BroadPhase::Grid);
+    ASSERT_EQ(query(fixed, box(0, 0, 50, 50)), (std::vector<size_t>{0}));
+    ASSERT_EQ(query(index, box(0, 0, 2.5, 1)), (std::vector<size_t>{0, 1, 2}));
+}
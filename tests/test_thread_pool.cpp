@@ -0,0 +1,31 @@
+#include <gtest/gtest.h>
+#include "utils/ThreadPool.h"
+#include <atomic>
+#include <vector>
+
+TEST(ThreadPoolTest, RunsTasksAndReturnsResults) {
+    ThreadPool pool(3);
+    ASSERT_EQ(pool.size(), 3);
+
+    std::vector<std::future<int>> results;
+    for (int i = 0; i < 20; ++i) {
+        results.push_back(pool.submit([i]() { return i * i; }));
+    }
+    for (int i = 0; i < 20; ++i) {
+        ASSERT_EQ(results[i].get(), i * i);
+    }
+}
+
+TEST(ThreadPoolTest, ShutdownDrainsQueueThenRunsInline) {
+    std::atomic<int> done{0};
+    ThreadPool pool(2);
+    for (int i = 0; i < 50; ++i) {
+        pool.submit([&done]() { done++; });
+    }
+    pool.shutdown();
+    ASSERT_EQ(done.load(), 50);
+
+    auto inlineResult = pool.submit([]() { return std::this_thread::get_id(); });
+    ASSERT_EQ(inlineResult.get(), std::this_thread::get_id());
+    pool.shutdown();
+}
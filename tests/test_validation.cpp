@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+#include "core/BinPacking.h"
+#include "core/Validation.h"
+#include "utils/WorkloadGenerator.h"
+#include <vector>
+
+namespace {
+    MArea createSquare(double x, double y, double side, int id) {
+        std::vector<MPointDouble> points = {
+            {x, y}, {x + side, y}, {x + side, y + side}, {x, y + side}
+        };
+        return MArea(points, id);
+    }
+}
+
+#if PACKING_ENABLE_VALIDATION
+
+// Every collision verdict of a pack over a mixed synthetic corpus agrees with the reference predicates.
+TEST(ValidationTest, SyntheticCorpusHasNoDisagreements) {
+    for (unsigned seed : {1u, 2u, 3u}) {
+        WorkloadGenerator::Options options;
+        options.pieces = 60;
+        options.seed = seed;
+        options.withHolesWeight = 1.0;
+        options.binWidth = 600;
+        options.binHeight = 400;
+        options.maxSize = 150;
+        auto instance = WorkloadGenerator::generate(options);
+        std::vector<MArea> pieces = WorkloadGenerator::toPieces(instance);
+
+        Validation::Options validationOptions;
+        validationOptions.rejectedSampleRate = 1.0;
+        Validation::start(validationOptions);
+        BinPacking::pack(pieces, instance.binDimension, false);
+        Validation::Report report = Validation::stop();
+
+        EXPECT_GT(report.acceptedChecked, 0u);
+        EXPECT_GT(report.rejectedChecked, 0u);
+        EXPECT_TRUE(report.ok()) << "seed " << seed << "\n" << report.format();
+    }
+}
+
+#endif
+
+TEST(ValidationTest, WrongVerdictsAreReported) {
+    Rectangle2D binDimension(MPointDouble(0, 0), MPointDouble(100, 100));
+    std::vector<MArea> placed = {createSquare(0, 0, 10, 1)};
+    MArea overlapping = createSquare(5, 5, 10, 2);
+    MArea free = createSquare(50, 50, 10, 3);
+    MArea outside = createSquare(95, 95, 10, 4);
+
+    Validation::Options options;
+    options.rejectedSampleRate = 1.0;
+    Validation::start(options);
+    Validation::checkCollision(overlapping, placed, std::nullopt, binDimension, false, Stats::Stage::DropPieces);
+    Validation::checkCollision(free, placed, std::nullopt, binDimension, true, Stats::Stage::DropPieces);
+    Validation::checkCollision(outside, placed, std::nullopt, binDimension, false, Stats::Stage::DropPieces);
+    // Correct verdicts, including a test that ignores the overlapping placed piece.
+    Validation::checkCollision(overlapping, placed, std::nullopt, binDimension, true, Stats::Stage::DropPieces);
+    Validation::checkCollision(overlapping, placed, 0, binDimension, false, Stats::Stage::DropPieces);
+    Validation::Report report = Validation::stop();
+
+    EXPECT_EQ(report.acceptedChecked, 3u);
+    EXPECT_EQ(report.rejectedChecked, 2u);
+    ASSERT_EQ(report.disagreementCount, 3u);
+    EXPECT_EQ(report.disagreements[0].kind, Validation::Kind::AcceptedButCollides);
+    EXPECT_FALSE(report.disagreements[0].otherWkt.empty());
+    EXPECT_EQ(report.disagreements[1].kind, Validation::Kind::RejectedButFree);
+    EXPECT_EQ(report.disagreements[2].kind, Validation::Kind::AcceptedOutsideBin);
+    EXPECT_NE(report.format().find("POLYGON"), std::string::npos);
+
+    // No session running: checks are not recorded.
+    Validation::checkCollision(overlapping, placed, std::nullopt, binDimension, false, Stats::Stage::DropPieces);
+    EXPECT_EQ(Validation::stop().acceptedChecked, 0u);
+}
@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+#include "utils/WorkloadGenerator.h"
+#include "utils/Utils.h"
+#include <boost/geometry/algorithms/is_convex.hpp>
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+    bool samePoints(const std::vector<MPointDouble>& a, const std::vector<MPointDouble>& b) {
+        return std::equal(a.begin(), a.end(), b.begin(), b.end(),
+            [](const MPointDouble& p, const MPointDouble& q) { return p == q; });
+    }
+
+    WorkloadGenerator::Options mixedOptions(unsigned seed) {
+        WorkloadGenerator::Options options;
+        options.pieces = 200;
+        options.seed = seed;
+        options.withHolesWeight = 1.0;
+        return options;
+    }
+}
+
+TEST(WorkloadGeneratorTest, SameSeedSameInstance) {
+    auto a = WorkloadGenerator::generate(mixedOptions(3));
+    auto b = WorkloadGenerator::generate(mixedOptions(3));
+    auto c = WorkloadGenerator::generate(mixedOptions(4));
+
+    ASSERT_EQ(a.pieces.size(), 200);
+    ASSERT_EQ(b.pieces.size(), a.pieces.size());
+    bool differentSeedDiffers = false;
+    for (size_t i = 0; i < a.pieces.size(); ++i) {
+        ASSERT_TRUE(samePoints(a.pieces[i].outer, b.pieces[i].outer));
+        ASSERT_EQ(a.pieces[i].holes.size(), b.pieces[i].holes.size());
+        for (size_t h = 0; h < a.pieces[i].holes.size(); ++h) {
+            ASSERT_TRUE(samePoints(a.pieces[i].holes[h], b.pieces[i].holes[h]));
+        }
+        differentSeedDiffers |= !samePoints(a.pieces[i].outer, c.pieces[i].outer);
+    }
+    ASSERT_TRUE(differentSeedDiffers);
+}
+
+TEST(WorkloadGeneratorTest, ShapesMatchTheirKind) {
+    auto instance = WorkloadGenerator::generate(mixedOptions(5));
+    std::vector<MArea> pieces = WorkloadGenerator::toPieces(instance);
+    ASSERT_EQ(pieces.size(), instance.pieces.size());
+
+    for (size_t i = 0; i < pieces.size(); ++i) {
+        const auto& generated = instance.pieces[i];
+        ASSERT_GT(pieces[i].getArea(), 0.0);
+        ASSERT_TRUE(pieces[i].isInside(instance.binDimension));
+
+        bg::model::ring<MPointDouble> outline;
+        bg::assign_points(outline, generated.outer);
+        bg::correct(outline);
+        switch (generated.kind) {
+            case WorkloadGenerator::ShapeKind::Rectangle:
+                ASSERT_EQ(generated.outer.size(), 4);
+                break;
+            case WorkloadGenerator::ShapeKind::Convex:
+                ASSERT_TRUE(bg::is_convex(outline));
+                break;
+            case WorkloadGenerator::ShapeKind::Concave:
+                ASSERT_FALSE(bg::is_convex(outline));
+                break;
+            case WorkloadGenerator::ShapeKind::WithHoles:
+                ASSERT_FALSE(generated.holes.empty());
+                ASSERT_LT(pieces[i].getArea(), bg::area(outline));
+                break;
+        }
+    }
+}
+
+TEST(WorkloadGeneratorTest, TextRoundTrip) {
+    auto instance = WorkloadGenerator::generate(mixedOptions(6));
+    std::vector<MArea> pieces = WorkloadGenerator::toPieces(instance);
+
+    std::string fileName = ::testing::TempDir() + "workload_generator_roundtrip.txt";
+    ASSERT_TRUE(WorkloadGenerator::writeText(instance, fileName));
+    auto loaded = Utils::loadPieces(fileName);
+    std::remove(fileName.c_str());
+
+    ASSERT_TRUE(loaded.has_value());
+    ASSERT_EQ(loaded->pieces.size(), pieces.size());
+    for (size_t i = 0; i < pieces.size(); ++i) {
+        ASSERT_EQ(loaded->pieces[i].getID(), pieces[i].getID());
+        ASSERT_NEAR(loaded->pieces[i].getArea(), pieces[i].getArea(), 1e-6);
+    }
+}
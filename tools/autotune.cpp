@@ -0,0 +1,340 @@
+#include "core/Bin.h"
+#include "core/BinPacking.h"
+#include "core/PackingConfig.h"
+#include "utils/Utils.h"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Auto-tuner for the step factors of PackingConfig.
+// Packs a corpus with every combination of the given factors, measures the wall time and
+// the number of bins of each configuration, prints the Pareto front of time vs bins and
+// saves the recommended profile as a config file for `packing_main --config=<file>`.
+
+#ifndef PACKING_SAMPLES_DIR
+#define PACKING_SAMPLES_DIR "samples"
+#endif
+
+namespace {
+
+struct Problem {
+    std::string name;
+    Utils::LoadResult data;
+};
+
+struct Evaluation {
+    PackingConfig config;
+    size_t bins = 0;            // Total bins over the corpus.
+    double fractionalBins = 0;  // Bins with the last bin of each problem counted by its utilisation.
+    double wallSeconds = 0;     // Total wall time over the corpus (minimum over the repeats).
+    bool timedOut = false;
+    bool pareto = false;
+};
+
+std::vector<double> parseList(const std::string& text) {
+    std::vector<double> values;
+    std::istringstream in(text);
+    std::string item;
+    while (std::getline(in, item, ',')) {
+        values.push_back(std::stod(item));
+    }
+    return values;
+}
+
+// "2/1,4/2" -> {{2, 1}, {4, 2}}
+std::vector<std::pair<double, double>> parsePairs(const std::string& text) {
+    std::vector<std::pair<double, double>> values;
+    std::istringstream in(text);
+    std::string item;
+    while (std::getline(in, item, ',')) {
+        auto pos = item.find('/');
+        if (pos == std::string::npos) {
+            throw std::invalid_argument(item);
+        }
+        values.emplace_back(std::stod(item.substr(0, pos)), std::stod(item.substr(pos + 1)));
+    }
+    return values;
+}
+
+std::vector<Problem> loadCorpus(const std::vector<std::string>& inputs) {
+    std::vector<std::filesystem::path> files;
+    for (const auto& input : inputs) {
+        std::error_code ec;
+        if (std::filesystem::is_directory(input, ec)) {
+            std::vector<std::filesystem::path> dirFiles;
+            for (const auto& entry : std::filesystem::directory_iterator(input, ec)) {
+                if (entry.is_regular_file() && entry.path().extension() == ".txt") {
+                    dirFiles.push_back(entry.path());
+                }
+            }
+            std::sort(dirFiles.begin(), dirFiles.end());
+            files.insert(files.end(), dirFiles.begin(), dirFiles.end());
+        } else if (std::filesystem::is_regular_file(input, ec)) {
+            files.emplace_back(input);
+        } else {
+            std::cerr << "Warning: Skipping " << input << ", not a file or directory." << std::endl;
+        }
+    }
+
+    std::vector<Problem> corpus;
+    for (const auto& file : files) {
+        if (auto loaded = Utils::loadPieces(file.string())) {
+            corpus.push_back({file.filename().string(), std::move(*loaded)});
+        }
+    }
+    return corpus;
+}
+
+Evaluation evaluate(const PackingConfig& config, const std::vector<Problem>& corpus, bool useParallel,
+                    double timeLimitSeconds, int repeats) {
+    Evaluation e;
+    e.config = config;
+    e.wallSeconds = std::numeric_limits<double>::max();
+
+    for (int repeat = 0; repeat < repeats && !e.timedOut; ++repeat) {
+        size_t bins = 0;
+        double fractionalBins = 0.0;
+        double wallSeconds = 0.0;
+        for (const auto& problem : corpus) {
+            // Runs over the time limit are cancelled from the progress callback.
+            Progress::CancellationToken cancellation;
+            BinPacking::PackOptions options;
+            options.useParallel = useParallel;
+            options.config = config;
+            options.cancellation = &cancellation;
+            if (timeLimitSeconds > 0) {
+                options.progressInterval = std::chrono::milliseconds(50);
+                options.onProgress = [&](const Progress::Report& r) {
+                    if (r.elapsedSeconds > timeLimitSeconds) {
+                        cancellation.cancel();
+                    }
+                };
+            }
+
+            std::vector<MArea> pieces = problem.data.pieces;
+            auto start = std::chrono::steady_clock::now();
+            std::vector<Bin> result = BinPacking::pack(pieces, problem.data.binDimension, options);
+            wallSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            if (cancellation.isCancelled()) {
+                e.timedOut = true;
+                break;
+            }
+            bins += result.size();
+            if (!result.empty()) {
+                const Rectangle2D& d = result.back().getDimension();
+                double lastUtilisation = result.back().getOccupiedArea() / (RectangleUtils::getWidth(d) * RectangleUtils::getHeight(d));
+                fractionalBins += static_cast<double>(result.size() - 1) + lastUtilisation;
+            }
+        }
+        e.bins = bins;
+        e.fractionalBins = fractionalBins;
+        e.wallSeconds = std::min(e.wallSeconds, wallSeconds);
+    }
+    return e;
+}
+
+// A configuration is on the Pareto front if no other one is at least as good on both
+// fractional bins and time, and strictly better on one of them.
+void markParetoFront(std::vector<Evaluation>& evaluations) {
+    for (auto& a : evaluations) {
+        if (a.timedOut) continue;
+        a.pareto = std::none_of(evaluations.begin(), evaluations.end(), [&a](const Evaluation& b) {
+            return !b.timedOut &&
+                   b.fractionalBins <= a.fractionalBins && b.wallSeconds <= a.wallSeconds &&
+                   (b.fractionalBins < a.fractionalBins || b.wallSeconds < a.wallSeconds);
+        });
+    }
+}
+
+void printRow(const Evaluation& e) {
+    std::cout << (e.pareto ? "* " : "  ") << std::left << std::setw(40) << e.config.toString() << std::right;
+    if (e.timedOut) {
+        std::cout << std::setw(8) << "-" << std::setw(12) << "-" << std::setw(10) << "timeout" << std::endl;
+        return;
+    }
+    std::cout << std::setw(8) << e.bins
+              << std::setw(12) << std::fixed << std::setprecision(3) << e.fractionalBins
+              << std::setw(10) << std::setprecision(3) << e.wallSeconds << std::endl;
+}
+
+void printUsage() {
+    std::cout << "Usage: packing_autotune [options] [<directory or file>...]" << std::endl;
+    std::cout << "  Packs the corpus (default: the samples directory) with every combination of step factors," << std::endl;
+    std::cout << "  prints the Pareto front of time vs bins and recommends a profile." << std::endl;
+    std::cout << "  --dive=<list>             : Values of dive_horizontal_displacement_factor (default 2,3,4)." << std::endl;
+    std::cout << "  --dx=<list>               : Values of dx_sweep_factor (default 5,10,15)." << std::endl;
+    std::cout << "  --dy=<list>               : Values of dy_sweep_factor (default 1,2,3)." << std::endl;
+    std::cout << "  --complex=<dx/dy list>    : Sweep factors of pieces over the vertex threshold (default 2/1)." << std::endl;
+    std::cout << "  --complex-threshold=<n>   : Vertex count above which a piece is complex (default 100)." << std::endl;
+    std::cout << "  --max-extra-bins=<n>      : Bins over the best result the recommended profile may use (default 0)." << std::endl;
+    std::cout << "  --time-limit=<seconds>    : Cancel a configuration when one problem takes longer than this." << std::endl;
+    std::cout << "  --repeat=<n>              : Runs per configuration; the fastest is kept (default 1)." << std::endl;
+    std::cout << "  --parallel                : Pack with the parallel implementation." << std::endl;
+    std::cout << "  --output=<file>           : Save the recommended profile as a config file." << std::endl;
+    std::cout << "  --csv=<file>              : Write every evaluation as CSV." << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> inputs;
+    std::vector<double> diveFactors = {2, 3, 4};
+    std::vector<double> dxFactors = {5, 10, 15};
+    std::vector<double> dyFactors = {1, 2, 3};
+    std::vector<std::pair<double, double>> complexFactors = {{2, 1}};
+    size_t complexThreshold = PackingConfig().complexPieceVertexThreshold;
+    size_t maxExtraBins = 0;
+    double timeLimitSeconds = 0;
+    int repeats = 1;
+    bool useParallel = false;
+    std::string outputFile;
+    std::string csvFile;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        std::string value = arg.substr(arg.find('=') + 1);
+        try {
+            if (arg == "-h" || arg == "--help") {
+                printUsage();
+                return 0;
+            } else if (arg.rfind("--dive=", 0) == 0) {
+                diveFactors = parseList(value);
+            } else if (arg.rfind("--dx=", 0) == 0) {
+                dxFactors = parseList(value);
+            } else if (arg.rfind("--dy=", 0) == 0) {
+                dyFactors = parseList(value);
+            } else if (arg.rfind("--complex=", 0) == 0) {
+                complexFactors = parsePairs(value);
+            } else if (arg.rfind("--complex-threshold=", 0) == 0) {
+                complexThreshold = std::stoul(value);
+            } else if (arg.rfind("--max-extra-bins=", 0) == 0) {
+                maxExtraBins = std::stoul(value);
+            } else if (arg.rfind("--time-limit=", 0) == 0) {
+                timeLimitSeconds = std::stod(value);
+            } else if (arg.rfind("--repeat=", 0) == 0) {
+                repeats = std::max(1, std::stoi(value));
+            } else if (arg == "--parallel") {
+                useParallel = true;
+            } else if (arg.rfind("--output=", 0) == 0) {
+                outputFile = value;
+            } else if (arg.rfind("--csv=", 0) == 0) {
+                csvFile = value;
+            } else if (arg.rfind("--", 0) == 0) {
+                std::cerr << "Error: Unknown option " << arg << std::endl;
+                printUsage();
+                return 2;
+            } else {
+                inputs.push_back(arg);
+            }
+        } catch (const std::exception&) {
+            std::cerr << "Error: Invalid argument " << arg << std::endl;
+            printUsage();
+            return 2;
+        }
+    }
+    if (inputs.empty()) {
+        inputs.push_back(PACKING_SAMPLES_DIR);
+    }
+
+    std::vector<PackingConfig> grid;
+    for (double dive : diveFactors) {
+        for (double dx : dxFactors) {
+            for (double dy : dyFactors) {
+                for (const auto& complex : complexFactors) {
+                    PackingConfig config;
+                    config.diveHorizontalDisplacementFactor = dive;
+                    config.dxSweepFactor = dx;
+                    config.dySweepFactor = dy;
+                    config.complexPieceVertexThreshold = complexThreshold;
+                    config.complexDxSweepFactor = complex.first;
+                    config.complexDySweepFactor = complex.second;
+                    if (dive > 0 && dx > 0 && dy > 0 && complex.first > 0 && complex.second > 0) {
+                        grid.push_back(config);
+                    }
+                }
+            }
+        }
+    }
+
+    std::vector<Problem> corpus = loadCorpus(inputs);
+    if (corpus.empty() || grid.empty()) {
+        std::cerr << "Error: Nothing to tune (" << corpus.size() << " problems, " << grid.size() << " configurations)." << std::endl;
+        return 2;
+    }
+    std::cout << "Tuning " << grid.size() << " configurations on " << corpus.size() << " problems." << std::endl;
+
+    std::vector<Evaluation> evaluations;
+    for (size_t i = 0; i < grid.size(); ++i) {
+        evaluations.push_back(evaluate(grid[i], corpus, useParallel, timeLimitSeconds, repeats));
+        std::cerr << "[" << (i + 1) << "/" << grid.size() << "] " << grid[i].toString() << std::endl;
+    }
+    markParetoFront(evaluations);
+
+    std::sort(evaluations.begin(), evaluations.end(), [](const Evaluation& a, const Evaluation& b) {
+        if (a.timedOut != b.timedOut) return !a.timedOut;
+        return a.wallSeconds < b.wallSeconds;
+    });
+    std::cout << "  " << std::left << std::setw(40) << "configuration" << std::right << std::setw(8) << "bins"
+              << std::setw(12) << "fracBins" << std::setw(10) << "time(s)" << std::endl;
+    for (const auto& e : evaluations) {
+        printRow(e);
+    }
+    std::cout << "(* = Pareto front of fractional bins vs time)" << std::endl;
+
+    // Recommended profile: the fastest configuration within maxExtraBins of the fewest bins found.
+    size_t bestBins = std::numeric_limits<size_t>::max();
+    for (const auto& e : evaluations) {
+        if (!e.timedOut) bestBins = std::min(bestBins, e.bins);
+    }
+    const Evaluation* recommended = nullptr;
+    for (const auto& e : evaluations) {
+        if (!e.timedOut && e.bins <= bestBins + maxExtraBins) {
+            recommended = &e; // Sorted by time, so the first match is the fastest.
+            break;
+        }
+    }
+    if (!recommended) {
+        std::cerr << "Error: Every configuration timed out." << std::endl;
+        return 1;
+    }
+    std::cout << "Recommended: " << recommended->config.toString() << " (" << recommended->bins << " bins, "
+              << std::fixed << std::setprecision(3) << recommended->wallSeconds << "s)" << std::endl;
+
+    if (!csvFile.empty()) {
+        std::ofstream csv(csvFile);
+        if (!csv.is_open()) {
+            std::cerr << "Error: Could not create CSV file " << csvFile << std::endl;
+            return 2;
+        }
+        csv << "dive,dx,dy,complex_threshold,complex_dx,complex_dy,bins,fractional_bins,wall_seconds,timed_out,pareto\n";
+        for (const auto& e : evaluations) {
+            const PackingConfig& c = e.config;
+            csv << c.diveHorizontalDisplacementFactor << "," << c.dxSweepFactor << "," << c.dySweepFactor << ","
+                << c.complexPieceVertexThreshold << "," << c.complexDxSweepFactor << "," << c.complexDySweepFactor << ","
+                << e.bins << "," << e.fractionalBins << "," << e.wallSeconds << "," << e.timedOut << "," << e.pareto << "\n";
+        }
+    }
+
+    if (!outputFile.empty()) {
+        std::ostringstream comment;
+        comment << "Recommended by packing_autotune on " << corpus.size() << " problems:";
+        for (const auto& problem : corpus) {
+            comment << " " << problem.name;
+        }
+        comment << "\n" << recommended->bins << " bins in " << std::fixed << std::setprecision(3) << recommended->wallSeconds
+                << "s (best found: " << bestBins << " bins)";
+        if (!recommended->config.save(outputFile, comment.str())) {
+            return 2;
+        }
+        std::cout << "Profile written to " << outputFile << std::endl;
+    }
+    return 0;
+}
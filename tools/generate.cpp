@@ -0,0 +1,130 @@
+#include "utils/Serialization.h"
+#include "utils/WorkloadGenerator.h"
+#include <iostream>
+#include <sstream>
+#include <string>
+
+// Synthetic workload generator for scaling studies.
+// Writes a reproducible, seeded problem file in the format read by packing_main.
+
+namespace {
+
+void printUsage() {
+    std::cout << "Usage: packing_generate [options] --output=<file>" << std::endl;
+    std::cout << "  --pieces=<n>            : Number of pieces (default 1000)." << std::endl;
+    std::cout << "  --seed=<n>              : Random seed; the same options and seed give the same instance (default 1)." << std::endl;
+    std::cout << "  --bin=<width>x<height>  : Bin dimensions (default 2000x1200)." << std::endl;
+    std::cout << "  --mix=<kind>:<weight>,..: Relative weights of rect, convex, concave and holes (default rect:1,convex:1,concave:1)." << std::endl;
+    std::cout << "  --vertices=<min>-<max>  : Vertex count of convex, concave and holed pieces (default 5-24)." << std::endl;
+    std::cout << "  --size=<min>-<max>      : Size of the larger side of each piece (default 20-300)." << std::endl;
+    std::cout << "  --distribution=<name>   : Size distribution: uniform, lognormal or bimodal (default uniform)." << std::endl;
+    std::cout << "  --decimals=<n>          : Decimals kept in the coordinates (default 2)." << std::endl;
+    std::cout << "  --output=<file>         : Text problem file to write." << std::endl;
+    std::cout << "  --binary                : Write the problem in the binary format instead (also read by packing_main)." << std::endl;
+}
+
+bool parsePair(const std::string& text, char separator, double& first, double& second) {
+    auto pos = text.find(separator);
+    if (pos == std::string::npos) return false;
+    try {
+        first = std::stod(text.substr(0, pos));
+        second = std::stod(text.substr(pos + 1));
+    } catch (const std::exception&) {
+        return false;
+    }
+    return first > 0 && second > 0;
+}
+
+bool parseRange(const std::string& text, double& lo, double& hi) {
+    return parsePair(text, '-', lo, hi) && hi >= lo;
+}
+
+bool parseMix(const std::string& text, WorkloadGenerator::Options& options) {
+    options.rectangleWeight = options.convexWeight = options.concaveWeight = options.withHolesWeight = 0.0;
+    std::istringstream in(text);
+    std::string item;
+    while (std::getline(in, item, ',')) {
+        auto pos = item.find(':');
+        if (pos == std::string::npos) return false;
+        std::string kind = item.substr(0, pos);
+        double weight;
+        try {
+            weight = std::stod(item.substr(pos + 1));
+        } catch (const std::exception&) {
+            return false;
+        }
+        if (kind == "rect") options.rectangleWeight = weight;
+        else if (kind == "convex") options.convexWeight = weight;
+        else if (kind == "concave") options.concaveWeight = weight;
+        else if (kind == "holes") options.withHolesWeight = weight;
+        else return false;
+    }
+    return options.rectangleWeight + options.convexWeight + options.concaveWeight + options.withHolesWeight > 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    WorkloadGenerator::Options options;
+    std::string outputFile;
+    bool binary = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        std::string value = arg.substr(arg.find('=') + 1);
+        bool ok = true;
+        if (arg == "-h" || arg == "--help") {
+            printUsage();
+            return 0;
+        } else if (arg.rfind("--pieces=", 0) == 0) {
+            options.pieces = std::stoul(value);
+        } else if (arg.rfind("--seed=", 0) == 0) {
+            options.seed = static_cast<unsigned>(std::stoul(value));
+        } else if (arg.rfind("--bin=", 0) == 0) {
+            ok = parsePair(value, 'x', options.binWidth, options.binHeight);
+        } else if (arg.rfind("--mix=", 0) == 0) {
+            ok = parseMix(value, options);
+        } else if (arg.rfind("--vertices=", 0) == 0) {
+            double lo, hi;
+            ok = parseRange(value, lo, hi);
+            if (ok) {
+                options.minVertices = static_cast<size_t>(lo);
+                options.maxVertices = static_cast<size_t>(hi);
+            }
+        } else if (arg.rfind("--size=", 0) == 0) {
+            ok = parseRange(value, options.minSize, options.maxSize);
+        } else if (arg.rfind("--distribution=", 0) == 0) {
+            auto distribution = WorkloadGenerator::parseSizeDistribution(value);
+            ok = distribution.has_value();
+            if (ok) options.sizeDistribution = *distribution;
+        } else if (arg.rfind("--decimals=", 0) == 0) {
+            options.decimals = std::stoi(value);
+        } else if (arg.rfind("--output=", 0) == 0) {
+            outputFile = value;
+        } else if (arg == "--binary") {
+            binary = true;
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            std::cerr << "Error: Invalid argument " << arg << std::endl;
+            printUsage();
+            return 1;
+        }
+    }
+
+    if (outputFile.empty()) {
+        std::cerr << "Error: No output file specified." << std::endl;
+        printUsage();
+        return 1;
+    }
+
+    WorkloadGenerator::Instance instance = WorkloadGenerator::generate(options);
+    bool written = binary ? Serialization::writeFile(outputFile, Serialization::serializeJob(instance.binDimension, WorkloadGenerator::toPieces(instance)))
+                          : WorkloadGenerator::writeText(instance, outputFile);
+    if (!written) {
+        return 1;
+    }
+    std::cout << "Generated " << instance.pieces.size() << " pieces (seed " << options.seed << ") in " << outputFile << std::endl;
+    return 0;
+}
@@ -0,0 +1,388 @@
+#include "core/Bin.h"
+#include "core/BinPacking.h"
+#include "core/Validation.h"
+#include "utils/Utils.h"
+#include <sys/resource.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Quality-and-speed regression harness.
+// Packs every problem file of the given directories (the samples by default), records the
+// number of bins, the utilisation of each bin, the wall time and the peak RSS, and compares
+// them against a stored baseline. Each file is packed in a forked child process so that
+// the peak RSS is measured per file. With --validate, every collision verdict of the run is
+// re-checked against the reference predicates (see core/Validation.h) and a disagreement
+// fails the file.
+
+#ifndef PACKING_SAMPLES_DIR
+#define PACKING_SAMPLES_DIR "samples"
+#endif
+
+namespace {
+
+struct RunResult {
+    std::string name;
+    bool ok = false;
+    size_t bins = 0;
+    std::vector<double> utilisation; // Occupied area over bin area, per bin.
+    double wallSeconds = 0.0;
+    long peakRssKb = 0;
+    bool validationFailed = false;
+
+    double meanUtilisation() const {
+        if (utilisation.empty()) return 0.0;
+        return std::accumulate(utilisation.begin(), utilisation.end(), 0.0) / utilisation.size();
+    }
+};
+
+struct Tolerances {
+    size_t bins = 0;             // Extra bins allowed.
+    double utilisation = 0.005;  // Absolute drop of the mean utilisation allowed.
+    double time = 0.5;           // Relative wall time increase allowed...
+    double timeSlack = 0.05;     // ...ignoring increases below this many seconds.
+    double rss = 0.25;           // Relative peak RSS increase allowed...
+    long rssSlackKb = 4096;      // ...ignoring increases below this many KB.
+    bool qualityOnly = false;    // Skip the machine-dependent time and memory checks.
+};
+
+// Line format shared by the results and baseline files:
+// <name> <bins> <wall seconds> <peak rss kb> <utilisation of bin 1>,<utilisation of bin 2>,...
+std::string formatResult(const RunResult& r) {
+    std::ostringstream out;
+    out << r.name << " " << r.bins << " " << std::fixed << std::setprecision(4) << r.wallSeconds << " " << r.peakRssKb << " ";
+    out << std::setprecision(6);
+    for (size_t i = 0; i < r.utilisation.size(); ++i) {
+        out << (i ? "," : "") << r.utilisation[i];
+    }
+    if (r.utilisation.empty()) {
+        out << "-";
+    }
+    return out.str();
+}
+
+bool parseResult(const std::string& line, RunResult& r) {
+    std::istringstream in(line);
+    std::string utilisation;
+    if (!(in >> r.name >> r.bins >> r.wallSeconds >> r.peakRssKb >> utilisation)) {
+        return false;
+    }
+    r.utilisation.clear();
+    if (utilisation != "-") {
+        std::istringstream values(utilisation);
+        std::string value;
+        while (std::getline(values, value, ',')) {
+            r.utilisation.push_back(std::stod(value));
+        }
+    }
+    r.ok = true;
+    return true;
+}
+
+std::map<std::string, RunResult> loadBaseline(const std::string& fileName) {
+    std::map<std::string, RunResult> baseline;
+    std::ifstream in(fileName);
+    if (!in.is_open()) {
+        std::cerr << "Error: Could not open baseline file " << fileName << std::endl;
+        return baseline;
+    }
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        RunResult r;
+        if (parseResult(line, r)) {
+            baseline[r.name] = r;
+        } else {
+            std::cerr << "Warning: Ignoring malformed baseline line '" << line << "'" << std::endl;
+        }
+    }
+    return baseline;
+}
+
+// Exit status of a child whose validation session found disagreements; the result line is still written.
+constexpr int VALIDATION_FAILED_EXIT = 3;
+
+// Runs in the forked child: packs the file and writes the result line to the pipe.
+// Returns the exit status of the child.
+int packInChild(const std::filesystem::path& file, bool useParallel, bool validate, int fd) {
+    RunResult r;
+    r.name = file.filename().string();
+    auto loadResult = Utils::loadPieces(file.string());
+    bool validationOk = true;
+    if (loadResult) {
+        if (validate) {
+            Validation::Options options;
+            options.rejectedSampleRate = 0.05;
+            Validation::start(options);
+        }
+        auto start = std::chrono::steady_clock::now();
+        std::vector<Bin> bins = BinPacking::pack(loadResult->pieces, loadResult->binDimension, useParallel);
+        r.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        r.bins = bins.size();
+        for (const auto& bin : bins) {
+            const Rectangle2D& d = bin.getDimension();
+            r.utilisation.push_back(bin.getOccupiedArea() / (RectangleUtils::getWidth(d) * RectangleUtils::getHeight(d)));
+        }
+        r.ok = true;
+        if (validate) {
+            Validation::Report report = Validation::stop();
+            if (!report.ok()) {
+                std::cerr << r.name << ": " << report.format();
+                validationOk = false;
+            }
+        }
+    }
+    std::string line = r.ok ? formatResult(r) + "\n" : "";
+    ssize_t written = write(fd, line.data(), line.size());
+    (void)written;
+    return validationOk ? 0 : VALIDATION_FAILED_EXIT;
+}
+
+RunResult runFile(const std::filesystem::path& file, bool useParallel, bool validate) {
+    RunResult r;
+    r.name = file.filename().string();
+
+    int fds[2];
+    if (pipe(fds) != 0) {
+        std::perror("pipe");
+        return r;
+    }
+    std::cout.flush();
+    std::cerr.flush();
+    pid_t pid = fork();
+    if (pid < 0) {
+        std::perror("fork");
+        close(fds[0]);
+        close(fds[1]);
+        return r;
+    }
+    if (pid == 0) {
+        close(fds[0]);
+        int exitStatus = packInChild(file, useParallel, validate, fds[1]);
+        close(fds[1]);
+        std::cerr.flush();
+        _exit(exitStatus);
+    }
+
+    close(fds[1]);
+    std::string output;
+    char buffer[4096];
+    ssize_t n;
+    while ((n = read(fds[0], buffer, sizeof(buffer))) > 0) {
+        output.append(buffer, static_cast<size_t>(n));
+    }
+    close(fds[0]);
+
+    int status = 0;
+    struct rusage usage {};
+    wait4(pid, &status, 0, &usage);
+    bool validationFailed = WIFEXITED(status) && WEXITSTATUS(status) == VALIDATION_FAILED_EXIT;
+    if (!WIFEXITED(status) || (WEXITSTATUS(status) != 0 && !validationFailed) || !parseResult(output, r)) {
+        std::cerr << "Error: Packing " << file << " failed." << std::endl;
+        r.ok = false;
+        return r;
+    }
+    r.validationFailed = validationFailed;
+#ifdef __APPLE__
+    r.peakRssKb = usage.ru_maxrss / 1024; // bytes on macOS
+#else
+    r.peakRssKb = usage.ru_maxrss;        // kilobytes on Linux
+#endif
+    return r;
+}
+
+std::vector<std::filesystem::path> collectFiles(const std::vector<std::string>& inputs) {
+    std::vector<std::filesystem::path> files;
+    for (const auto& input : inputs) {
+        std::error_code ec;
+        if (std::filesystem::is_directory(input, ec)) {
+            std::vector<std::filesystem::path> dirFiles;
+            for (const auto& entry : std::filesystem::directory_iterator(input, ec)) {
+                if (entry.is_regular_file() && entry.path().extension() == ".txt") {
+                    dirFiles.push_back(entry.path());
+                }
+            }
+            std::sort(dirFiles.begin(), dirFiles.end());
+            files.insert(files.end(), dirFiles.begin(), dirFiles.end());
+        } else if (std::filesystem::is_regular_file(input, ec)) {
+            files.emplace_back(input);
+        } else {
+            std::cerr << "Warning: Skipping " << input << ", not a file or directory." << std::endl;
+        }
+    }
+    return files;
+}
+
+// Returns the list of regressions of the current result with respect to the baseline.
+std::vector<std::string> compare(const RunResult& current, const RunResult& base, const Tolerances& tol) {
+    std::vector<std::string> failures;
+    std::ostringstream msg;
+    msg << std::fixed << std::setprecision(4);
+    if (current.bins > base.bins + tol.bins) {
+        msg.str("");
+        msg << "bins " << base.bins << " -> " << current.bins;
+        failures.push_back(msg.str());
+    }
+    if (current.meanUtilisation() < base.meanUtilisation() - tol.utilisation) {
+        msg.str("");
+        msg << "mean utilisation " << base.meanUtilisation() << " -> " << current.meanUtilisation();
+        failures.push_back(msg.str());
+    }
+    if (!tol.qualityOnly) {
+        if (current.wallSeconds > base.wallSeconds * (1.0 + tol.time) && current.wallSeconds - base.wallSeconds > tol.timeSlack) {
+            msg.str("");
+            msg << "wall time " << base.wallSeconds << "s -> " << current.wallSeconds << "s";
+            failures.push_back(msg.str());
+        }
+        if (current.peakRssKb > base.peakRssKb * (1.0 + tol.rss) && current.peakRssKb - base.peakRssKb > tol.rssSlackKb) {
+            msg.str("");
+            msg << "peak RSS " << base.peakRssKb << "KB -> " << current.peakRssKb << "KB";
+            failures.push_back(msg.str());
+        }
+    }
+    return failures;
+}
+
+void printUsage() {
+    std::cout << "Usage: packing_regression [options] [<directory or file>...]" << std::endl;
+    std::cout << "  Packs every .txt problem file (default: the samples directory) and compares the results to a baseline." << std::endl;
+    std::cout << "  --baseline=<file>            : Baseline to compare against. Without it the results are only reported." << std::endl;
+    std::cout << "  --output=<file>              : Write the results in baseline format (use it to record a new baseline)." << std::endl;
+    std::cout << "  --parallel                   : Pack with the parallel implementation." << std::endl;
+    std::cout << "  --quality-only               : Only check bins and utilisation, not wall time or peak RSS." << std::endl;
+    std::cout << "  --validate                   : Re-check the collision verdicts with the reference predicates; a disagreement fails the file." << std::endl;
+    std::cout << "  --bins-tolerance=<n>         : Extra bins allowed per file (default 0)." << std::endl;
+    std::cout << "  --utilisation-tolerance=<x>  : Absolute drop of mean utilisation allowed (default 0.005)." << std::endl;
+    std::cout << "  --time-tolerance=<x>         : Relative wall time increase allowed (default 0.5)." << std::endl;
+    std::cout << "  --rss-tolerance=<x>          : Relative peak RSS increase allowed (default 0.25)." << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> inputs;
+    std::string baselineFile;
+    std::string outputFile;
+    bool useParallel = false;
+    bool validate = false;
+    Tolerances tol;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&arg]() { return arg.substr(arg.find('=') + 1); };
+        if (arg == "-h" || arg == "--help") {
+            printUsage();
+            return 0;
+        } else if (arg.rfind("--baseline=", 0) == 0) {
+            baselineFile = value();
+        } else if (arg.rfind("--output=", 0) == 0) {
+            outputFile = value();
+        } else if (arg == "--parallel") {
+            useParallel = true;
+        } else if (arg == "--validate") {
+            validate = true;
+        } else if (arg == "--quality-only") {
+            tol.qualityOnly = true;
+        } else if (arg.rfind("--bins-tolerance=", 0) == 0) {
+            tol.bins = std::stoul(value());
+        } else if (arg.rfind("--utilisation-tolerance=", 0) == 0) {
+            tol.utilisation = std::stod(value());
+        } else if (arg.rfind("--time-tolerance=", 0) == 0) {
+            tol.time = std::stod(value());
+        } else if (arg.rfind("--rss-tolerance=", 0) == 0) {
+            tol.rss = std::stod(value());
+        } else if (arg.rfind("--", 0) == 0) {
+            std::cerr << "Error: Unknown option " << arg << std::endl;
+            printUsage();
+            return 2;
+        } else {
+            inputs.push_back(arg);
+        }
+    }
+    if (inputs.empty()) {
+        inputs.push_back(PACKING_SAMPLES_DIR);
+    }
+
+    std::map<std::string, RunResult> baseline;
+    if (!baselineFile.empty()) {
+        baseline = loadBaseline(baselineFile);
+        if (baseline.empty()) {
+            return 2;
+        }
+    }
+
+    std::vector<std::filesystem::path> files = collectFiles(inputs);
+    std::vector<RunResult> results;
+    int nRegressions = 0;
+    int nErrors = 0;
+    int nValidationFailures = 0;
+
+    std::cout << std::left << std::setw(24) << "file" << std::right << std::setw(6) << "bins" << std::setw(10) << "util"
+              << std::setw(10) << "time(s)" << std::setw(12) << "rss(KB)" << "  status" << std::endl;
+    for (const auto& file : files) {
+        RunResult r = runFile(file, useParallel, validate);
+        if (!r.ok) {
+            nErrors++;
+            continue;
+        }
+        results.push_back(r);
+
+        std::string status = "ok";
+        std::vector<std::string> failures;
+        auto it = baseline.find(r.name);
+        if (r.validationFailed) {
+            status = "VALIDATION FAILED";
+            nValidationFailures++;
+        } else if (baselineFile.empty()) {
+            status = validate ? "validated" : "-";
+        } else if (it == baseline.end()) {
+            status = "new (not in baseline)";
+        } else {
+            failures = compare(r, it->second, tol);
+            if (!failures.empty()) {
+                status = "REGRESSION";
+                nRegressions++;
+            }
+        }
+        std::cout << std::left << std::setw(24) << r.name << std::right << std::setw(6) << r.bins
+                  << std::setw(10) << std::fixed << std::setprecision(4) << r.meanUtilisation()
+                  << std::setw(10) << std::setprecision(3) << r.wallSeconds
+                  << std::setw(12) << r.peakRssKb << "  " << status << std::endl;
+        for (const auto& failure : failures) {
+            std::cout << "    " << failure << std::endl;
+        }
+    }
+
+    if (!outputFile.empty()) {
+        std::ofstream out(outputFile);
+        if (!out.is_open()) {
+            std::cerr << "Error: Could not create output file " << outputFile << std::endl;
+            return 2;
+        }
+        out << "# <file> <bins> <wall seconds> <peak rss kb> <utilisation per bin>" << std::endl;
+        for (const auto& r : results) {
+            out << formatResult(r) << std::endl;
+        }
+        std::cout << "Results written to " << outputFile << std::endl;
+    }
+
+    if (nErrors > 0 || nRegressions > 0 || nValidationFailures > 0) {
+        std::cout << nRegressions << " regression(s), " << nValidationFailures << " validation failure(s), "
+                  << nErrors << " error(s)." << std::endl;
+        return 1;
+    }
+    return 0;
+}